@@ -1,5 +1,6 @@
 #include <iostream>
 #include <fstream>
+#include <memory>
 
 #include "OmegaSemigroup.h"
 #include "IOHandler.h"
@@ -8,7 +9,7 @@
 
 /**
  * Reads an omega semigroup from an input file, and determines whether its language is
- * det. Buechi/CoBuechi/Weak Buechi/E/A-recognizable.
+ * det. Buechi/CoBuechi/Weak Buechi/E/A-recognizable and, on request, first-order definable.
  * @param argc The number of command line arguments.
  * @param argv The Command line arguments.
  * @return 0 if and only if successful.
@@ -22,6 +23,9 @@ int main(int argc, char const* argv[]) {
   optParser.setOption("output_file", "o", "output-file", "Path to output file for results");
   optParser.addFlag("help", "h", "help", "Print usage text");
   optParser.addFlag("suppress_output", "s", "suppress-output", "Suppress output of warnings by oslh");
+  optParser.addFlag("no_validation", "n", "no-validation", "Do not check the omega semigroup axioms of the input");
+  optParser.addFlag("first_order", "f", "first-order", "Also decide first-order (LTL) definability, which requires "
+                                                       "minimizing the omega semigroup");
 
   //Parse the command line options
   try {
@@ -44,6 +48,12 @@ int main(int argc, char const* argv[]) {
   //Determine whether to suppress warnings
   bool suppressWarnings = optParser.isSet("suppress_output");
 
+  //Determine whether to check the input
+  bool validate = !optParser.isSet("no_validation");
+
+  //Determine whether to decide first-order definability
+  bool firstOrder = optParser.isSet("first_order");
+
   //Declare pointer to omega semigroup to be read
   std::unique_ptr<omalg::OmegaSemigroup> S;
 
@@ -58,7 +68,7 @@ int main(int argc, char const* argv[]) {
     }
     //Reading from stdin
     try {
-      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromStdin());
+      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromStdin(validate));
     }
     catch(omalg::IOException const &e) {
       //An error occurred while reading
@@ -72,7 +82,7 @@ int main(int argc, char const* argv[]) {
   else {
     //Input file was specified
     try {
-      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromFile(inputFile));
+      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromFile(inputFile, validate));
     }
     catch(omalg::IOException const &e) {
       //An error occurred while reading
@@ -84,14 +94,25 @@ int main(int argc, char const* argv[]) {
     }
   }
 
+  //Remove elements not generated by the alphabet
+  S->reduceToGenerated();
+
   //build result
+  unsigned classes = S->landweberClasses();
   std::string resultString = "";
   resultString += "The language of this omega semigroup is:\n";
-  resultString += (S->isDBRecognizable() ? " - " : " - not ") + std::string("deterministic Buechi recognizable\n");
-  resultString += (S->isDCRecognizable() ? " - " : " - not ") + std::string("coBuechi recognizable\n");
-  resultString += (S->isWBRecognizable() ? " - " : " - not ") + std::string("weak Buechi recognizable\n");
-  resultString += (S->isERecognizable() ? " - " : " - not ") + std::string("E recognizable\n");
-  resultString += (S->isARecognizable() ? " - " : " - not ") + std::string("A recognizable\n");
+  resultString += (classes & omalg::OmegaSemigroup::DB ? " - " : " - not ") + std::string("deterministic Buechi recognizable\n");
+  resultString += (classes & omalg::OmegaSemigroup::DC ? " - " : " - not ") + std::string("coBuechi recognizable\n");
+  resultString += (classes & omalg::OmegaSemigroup::WB ? " - " : " - not ") + std::string("weak Buechi recognizable\n");
+  resultString += (classes & omalg::OmegaSemigroup::E ? " - " : " - not ") + std::string("E recognizable\n");
+  resultString += (classes & omalg::OmegaSemigroup::A ? " - " : " - not ") + std::string("A recognizable\n");
+  if (firstOrder) {
+    //First-order definability is a property of the syntactic omega semigroup. The Landweber classes are
+    //already decided, so S is reduced in place.
+    S->reduceToSyntactic();
+    bool aperiodic = S->isAperiodic();
+    resultString += (aperiodic ? " - " : " - not ") + std::string("first-order (LTL) definable\n");
+  }
 
   //get output file
   std::string outputFile = optParser.getValue("output_file");
@@ -0,0 +1,185 @@
+#include <iostream>
+#include <fstream>
+#include <memory>
+
+#include "OmegaSemigroup.h"
+#include "IOHandler.h"
+#include "IOHandlerExceptions.h"
+#include "OptParser.h"
+#include "AutomatonSink.h"
+
+/**
+ * Reads an omega semigroup from an input file, and transforms it into equivalent automata
+ * of several kinds at once (where possible).
+ * @param argc The number of command line arguments.
+ * @param argv The Command line arguments.
+ * @return 0 if and only if successful.
+ */
+int main(int argc, char const* argv[]) {
+//Creation of OptParser and setup of supported options
+  Kanedo::OptParser optParser = Kanedo::OptParser();
+  optParser.setHelpText("Given an omega semigroup, construct automata of the requested kinds "
+                            "for its language in one run.");
+  optParser.setOption("input_file", "i", "input-file", "Path to input file for omega semigroup");
+  optParser.setOption("weak_buechi_file", "w", "weak-buechi", "Path to output file for weak Buechi automaton");
+  optParser.setOption("cobuechi_file", "c", "cobuechi", "Path to output file for coBuechi automaton");
+  optParser.setOption("det_buechi_file", "d", "det-buechi", "Path to output file for det. Buechi automaton");
+  optParser.setOption("parity_file", "p", "parity", "Path to output file for parity automaton");
+  optParser.addFlag("help", "h", "help", "Print usage text");
+  optParser.addFlag("suppress_output", "s", "suppress-output", "Suppress output of warnings by os2a");
+  optParser.addFlag("no_validation", "n", "no-validation", "Do not check the omega semigroup axioms of the input");
+  optParser.setOption("threads", "t", "threads", "Number of threads for the construction, 0 for one per core (default 1)");
+
+  //Parse the command line options
+  try {
+    optParser.parseOptions(argc, argv);
+  }
+  catch (const Kanedo::UnknownOptionException &E) {
+    std::cerr << "Error: Unknown option: " << E.getOptionName() << std::endl;;
+    std::cerr << "Type os2a -h for help" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  //Show help text if requested
+  if(optParser.isSet("help")) {
+    optParser.showUsage();
+    std::cout << "Consult the manual for additional help and examples.";
+    std::cout << std::endl;
+    return 0;
+  }
+
+  //Get output files, in the order weak Buechi, coBuechi, det. Buechi, parity
+  std::string const options[4] = { "weak_buechi_file", "cobuechi_file", "det_buechi_file", "parity_file" };
+  std::string const kinds[4] = { "weak Buechi", "coBuechi", "det. Buechi", "parity" };
+  std::string outputFiles[4];
+  bool requested = false;
+  for (size_t i = 0; i < 4; ++i) {
+    outputFiles[i] = optParser.getValue(options[i]);
+    requested = requested || !outputFiles[i].empty();
+  }
+  if (!requested) {
+    std::cerr << "Error: No output file specified." << std::endl;
+    std::cerr << "Type os2a -h for help" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  //Determine whether to suppress warnings
+  bool suppressWarnings = optParser.isSet("suppress_output");
+
+  //Determine whether to check the input
+  bool validate = !optParser.isSet("no_validation");
+
+  //Determine number of threads
+  unsigned threads = 1;
+  std::string threadsValue = optParser.getValue("threads");
+  if (!threadsValue.empty()) {
+    try {
+      threads = static_cast<unsigned>(std::stoul(threadsValue));
+    }
+    catch (std::exception const&) {
+      std::cerr << "Error: Invalid number of threads: " << threadsValue << std::endl;
+      std::cerr << "Type os2a -h for help" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  //Declare pointer to omega semigroup to be read
+  std::unique_ptr<omalg::OmegaSemigroup> S;
+
+  //Get input file
+  std::string inputFile = optParser.getValue("input_file");
+
+  if(inputFile.empty()) {
+    //No input file specified
+    if(!suppressWarnings) {
+      std::cerr << "Warning: No input file specified. Reading from stdin. (Type os2a -h for help)";
+      std::cerr << std::endl;
+    }
+    //Reading from stdin
+    try {
+      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromStdin(validate));
+    }
+    catch(omalg::IOException const &e) {
+      //An error occurred while reading
+      std::cerr << "Error: failed to read omega semigroup from stdin";
+      std::cerr << std::endl;
+      std::cerr << e.what();
+      std::cerr << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  else {
+    //Input file was specified
+    try {
+      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromFile(inputFile, validate));
+    }
+    catch(omalg::IOException const &e) {
+      //An error occurred while reading
+      std::cerr << "Error: failed to read omega semigroup from file " << inputFile;
+      std::cerr << std::endl;
+      std::cerr << e.what();
+      std::cerr << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  //Remove elements not generated by the alphabet
+  S->reduceToGenerated();
+
+  //Decide the Landweber classes first, so no output file is opened for a kind not recognizing the language
+  unsigned classes = S->landweberClasses();
+  unsigned const required[4] = { omalg::OmegaSemigroup::WB, omalg::OmegaSemigroup::DC, omalg::OmegaSemigroup::DB, 0 };
+  int result = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    if (!outputFiles[i].empty() && (classes & required[i]) != required[i]) {
+      std::cerr << "Given omega semigroup can not be transformed into equivalent " << kinds[i] << " automaton.";
+      std::cerr << std::endl;
+      std::cerr << "The language is not " << kinds[i] << " recognizable.";
+      std::cerr << std::endl;
+      outputFiles[i].clear();
+      result = EXIT_FAILURE;
+    }
+  }
+
+  //Open output files
+  std::ofstream out[4];
+  std::unique_ptr<omalg::StreamAutomatonSink> sinks[4];
+  for (size_t i = 0; i < 4; ++i) {
+    if (outputFiles[i].empty()) {
+      continue;
+    }
+    out[i].open(outputFiles[i], std::ios::out);
+    if (!out[i].good()) {
+      std::cerr << "Failed to open file " + outputFiles[i] + ".";
+      std::cerr << std::endl;
+      return EXIT_FAILURE;
+    }
+    sinks[i] = std::unique_ptr<omalg::StreamAutomatonSink>(new omalg::StreamAutomatonSink(out[i]));
+  }
+
+  //construct results
+  try {
+    S->toAutomata(sinks[0].get(), sinks[1].get(), sinks[2].get(), sinks[3].get(), threads);
+  }
+  catch (omalg::IOException const &e) {
+    std::cerr << "Error: failed to write automaton";
+    std::cerr << std::endl;
+    std::cerr << e.what();
+    std::cerr << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  //Close output files
+  for (size_t i = 0; i < 4; ++i) {
+    if (outputFiles[i].empty()) {
+      continue;
+    }
+    out[i].close();
+    if (out[i].fail()) {
+      std::cerr << "Failed to close file " + outputFiles[i] + ".";
+      std::cerr << std::endl;
+      result = EXIT_FAILURE;
+    }
+  }
+  return result;
+}
@@ -1,11 +1,11 @@
 #include <iostream>
-#include <fstream>
+#include <memory>
 
 #include "OmegaSemigroup.h"
 #include "IOHandler.h"
 #include "IOHandlerExceptions.h"
 #include "OptParser.h"
-#include "DeterministicCoBuechiAutomaton.h"
+#include "AutomatonSink.h"
 
 /**
  * Reads an omega semigroup from an input file, and transforms it into an equivalent
@@ -23,6 +23,8 @@ int main(int argc, char const* argv[]) {
   optParser.setOption("output_file", "o", "output-file", "Path to output file for resulting automaton");
   optParser.addFlag("help", "h", "help", "Print usage text");
   optParser.addFlag("suppress_output", "s", "suppress-output", "Suppress output of warnings by os2c");
+  optParser.addFlag("no_validation", "n", "no-validation", "Do not check the omega semigroup axioms of the input");
+  optParser.setOption("threads", "t", "threads", "Number of threads for the construction, 0 for one per core (default 1)");
 
   //Parse the command line options
   try {
@@ -45,6 +47,23 @@ int main(int argc, char const* argv[]) {
   //Determine whether to suppress warnings
   bool suppressWarnings = optParser.isSet("suppress_output");
 
+  //Determine whether to check the input
+  bool validate = !optParser.isSet("no_validation");
+
+  //Determine number of threads
+  unsigned threads = 1;
+  std::string threadsValue = optParser.getValue("threads");
+  if (!threadsValue.empty()) {
+    try {
+      threads = static_cast<unsigned>(std::stoul(threadsValue));
+    }
+    catch (std::exception const&) {
+      std::cerr << "Error: Invalid number of threads: " << threadsValue << std::endl;
+      std::cerr << "Type os2c -h for help" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
   //Declare pointer to omega semigroup to be read
   std::unique_ptr<omalg::OmegaSemigroup> S;
 
@@ -59,7 +78,7 @@ int main(int argc, char const* argv[]) {
     }
     //Reading from stdin
     try {
-      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromStdin());
+      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromStdin(validate));
     }
     catch(omalg::IOException const &e) {
       //An error occurred while reading
@@ -73,7 +92,7 @@ int main(int argc, char const* argv[]) {
   else {
     //Input file was specified
     try {
-      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromFile(inputFile));
+      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromFile(inputFile, validate));
     }
     catch(omalg::IOException const &e) {
       //An error occurred while reading
@@ -85,39 +104,47 @@ int main(int argc, char const* argv[]) {
     }
   }
 
-  //construct result
-  try {
-    omalg::DeterministicCoBuechiAutomaton A = S->toCoBuechi();
+  //Remove elements not generated by the alphabet
+  S->reduceToGenerated();
 
-    //get output file
-    std::string outputFile = optParser.getValue("output_file");
+  //get output file
+  std::string outputFile = optParser.getValue("output_file");
 
-    //write to output file
+  //construct result and write it to the output state by state
+  try {
     if (outputFile.empty()) {
       //No output file specified
       if (!suppressWarnings) {
         std::cerr << "Warning: No output file specified. Writing to stdout. (Type os2c -h for help)";
         std::cerr << std::endl;
       }
-      std::cout << A.description();
+      omalg::StreamAutomatonSink sink(std::cout);
+      S->toCoBuechi(sink, threads);
     }
     else {
-      std::ofstream out;
-      out.open(outputFile, std::ios::out);
-      if (!out.good()) {
-        std::cerr << "Failed to open file " + outputFile + ".";
-        std::cerr << std::endl;
-        return EXIT_FAILURE;
-      }
-      out << A.description();
-      out.close();
-      if (out.fail()) {
-        std::cerr << "Failed to close file " + outputFile + ".";
-        std::cerr << std::endl;
-      }
+      //The file is only opened once the automaton is known to exist, an existing file is kept otherwise
+      omalg::FileAutomatonSink sink(outputFile);
+      S->toCoBuechi(sink, threads);
     }
     return 0;
   }
+  catch (omalg::OpenFailedException const&) {
+    std::cerr << "Failed to open file " + outputFile + ".";
+    std::cerr << std::endl;
+    return EXIT_FAILURE;
+  }
+  catch (omalg::CloseFailedException const&) {
+    std::cerr << "Failed to close file " + outputFile + ".";
+    std::cerr << std::endl;
+    return EXIT_FAILURE;
+  }
+  catch (omalg::IOException const &e) {
+    std::cerr << "Error: failed to write automaton";
+    std::cerr << std::endl;
+    std::cerr << e.what();
+    std::cerr << std::endl;
+    return EXIT_FAILURE;
+  }
   catch (omalg::OperationNotApplicableException const& e) {
     std::cerr << "Given omega semigroup can not be transformed into equivalent coBuechi automaton." ;
     std::cerr << std::endl;
@@ -1,11 +1,13 @@
+#include <cstdio>
 #include <iostream>
 #include <fstream>
+#include <memory>
 
 #include "OmegaSemigroup.h"
 #include "IOHandler.h"
 #include "IOHandlerExceptions.h"
 #include "OptParser.h"
-#include "DeterministicParityAutomaton.h"
+#include "AutomatonSink.h"
 
 /**
  * Reads an omega semigroup from an input file, and transforms it into an equivalent
@@ -23,6 +25,8 @@ int main(int argc, char const* argv[]) {
   optParser.setOption("output_file", "o", "output-file", "Path to output file for resulting automaton");
   optParser.addFlag("help", "h", "help", "Print usage text");
   optParser.addFlag("suppress_output", "s", "suppress-output", "Suppress output of warnings by os2p");
+  optParser.addFlag("no_validation", "n", "no-validation", "Do not check the omega semigroup axioms of the input");
+  optParser.setOption("threads", "t", "threads", "Number of threads for the construction, 0 for one per core (default 1)");
 
   //Parse the command line options
   try {
@@ -45,6 +49,23 @@ int main(int argc, char const* argv[]) {
   //Determine whether to suppress warnings
   bool suppressWarnings = optParser.isSet("suppress_output");
 
+  //Determine whether to check the input
+  bool validate = !optParser.isSet("no_validation");
+
+  //Determine number of threads
+  unsigned threads = 1;
+  std::string threadsValue = optParser.getValue("threads");
+  if (!threadsValue.empty()) {
+    try {
+      threads = static_cast<unsigned>(std::stoul(threadsValue));
+    }
+    catch (std::exception const&) {
+      std::cerr << "Error: Invalid number of threads: " << threadsValue << std::endl;
+      std::cerr << "Type os2p -h for help" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
   //Declare pointer to omega semigroup to be read
   std::unique_ptr<omalg::OmegaSemigroup> S;
 
@@ -59,7 +80,7 @@ int main(int argc, char const* argv[]) {
     }
     //Reading from stdin
     try {
-      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromStdin());
+      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromStdin(validate));
     }
     catch(omalg::IOException const &e) {
       //An error occurred while reading
@@ -73,7 +94,7 @@ int main(int argc, char const* argv[]) {
   else {
     //Input file was specified
     try {
-      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromFile(inputFile));
+      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromFile(inputFile, validate));
     }
     catch(omalg::IOException const &e) {
       //An error occurred while reading
@@ -85,36 +106,47 @@ int main(int argc, char const* argv[]) {
     }
   }
 
-  //construct result
-  omalg::DeterministicParityAutomaton A = S->toParity();
+  //Remove elements not generated by the alphabet
+  S->reduceToGenerated();
 
   //get output file
   std::string outputFile = optParser.getValue("output_file");
 
-  //write to output file
-  if (outputFile.empty()) {
-    //No output file specified
-    if (!suppressWarnings) {
-      std::cerr << "Warning: No output file specified. Writing to stdout. (Type os2p -h for help)";
-      std::cerr << std::endl;
-    }
-    std::cout << A.description();
-  }
-  else {
-    std::ofstream out;
-    out.open(outputFile, std::ios::out);
-    if (!out.good()) {
-      std::cerr << "Failed to open file " + outputFile + ".";
-      std::cerr << std::endl;
-      return EXIT_FAILURE;
+  //construct result and write it to the output state by state
+  try {
+    if (outputFile.empty()) {
+      //No output file specified
+      if (!suppressWarnings) {
+        std::cerr << "Warning: No output file specified. Writing to stdout. (Type os2p -h for help)";
+        std::cerr << std::endl;
+      }
+      omalg::StreamAutomatonSink sink(std::cout);
+      S->toParity(sink, threads);
     }
-    out << A.description();
-    out.close();
-    if (out.fail()) {
-      std::cerr << "Failed to close file " + outputFile + ".";
-      std::cerr << std::endl;
+    else {
+      std::ofstream out;
+      out.open(outputFile, std::ios::out);
+      if (!out.good()) {
+        std::cerr << "Failed to open file " + outputFile + ".";
+        std::cerr << std::endl;
+        return EXIT_FAILURE;
+      }
+      omalg::StreamAutomatonSink sink(out);
+      S->toParity(sink, threads);
+      out.close();
+      if (out.fail()) {
+        std::cerr << "Failed to close file " + outputFile + ".";
+        std::cerr << std::endl;
+      }
     }
   }
+  catch (omalg::IOException const &e) {
+    std::cerr << "Error: failed to write automaton";
+    std::cerr << std::endl;
+    std::cerr << e.what();
+    std::cerr << std::endl;
+    return EXIT_FAILURE;
+  }
   return 0;
 
 
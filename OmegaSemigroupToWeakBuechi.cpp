@@ -1,11 +1,11 @@
 #include <iostream>
-#include <fstream>
+#include <memory>
 
 #include "OmegaSemigroup.h"
 #include "IOHandler.h"
 #include "IOHandlerExceptions.h"
 #include "OptParser.h"
-#include "DeterministicBuechiAutomaton.h"
+#include "AutomatonSink.h"
 
 /**
  * Reads an omega semigroup from an input file, and transforms it into an equivalent weak
@@ -23,6 +23,7 @@ int main(int argc, char const* argv[]) {
   optParser.setOption("output_file", "o", "output-file", "Path to output file for resulting automaton");
   optParser.addFlag("help", "h", "help", "Print usage text");
   optParser.addFlag("suppress_output", "s", "suppress-output", "Suppress output of warnings by os2w");
+  optParser.addFlag("no_validation", "n", "no-validation", "Do not check the omega semigroup axioms of the input");
 
   //Parse the command line options
   try {
@@ -45,6 +46,9 @@ int main(int argc, char const* argv[]) {
   //Determine whether to suppress warnings
   bool suppressWarnings = optParser.isSet("suppress_output");
 
+  //Determine whether to check the input
+  bool validate = !optParser.isSet("no_validation");
+
   //Declare pointer to omega semigroup to be read
   std::unique_ptr<omalg::OmegaSemigroup> S;
 
@@ -59,7 +63,7 @@ int main(int argc, char const* argv[]) {
     }
     //Reading from stdin
     try {
-      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromStdin());
+      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromStdin(validate));
     }
     catch(omalg::IOException const &e) {
       //An error occurred while reading
@@ -73,7 +77,7 @@ int main(int argc, char const* argv[]) {
   else {
     //Input file was specified
     try {
-      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromFile(inputFile));
+      S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromFile(inputFile, validate));
     }
     catch(omalg::IOException const &e) {
       //An error occurred while reading
@@ -85,39 +89,47 @@ int main(int argc, char const* argv[]) {
     }
   }
 
-  //construct result
-  try {
-    omalg::DeterministicBuechiAutomaton A = S->toWeakBuechi();
+  //Remove elements not generated by the alphabet
+  S->reduceToGenerated();
 
-    //get output file
-    std::string outputFile = optParser.getValue("output_file");
+  //get output file
+  std::string outputFile = optParser.getValue("output_file");
 
-    //write to output file
+  //construct result and write it to the output state by state
+  try {
     if (outputFile.empty()) {
       //No output file specified
       if (!suppressWarnings) {
         std::cerr << "Warning: No output file specified. Writing to stdout. (Type os2w -h for help)";
         std::cerr << std::endl;
       }
-      std::cout << A.description();
+      omalg::StreamAutomatonSink sink(std::cout);
+      S->toWeakBuechi(sink);
     }
     else {
-      std::ofstream out;
-      out.open(outputFile, std::ios::out);
-      if (!out.good()) {
-        std::cerr << "Failed to open file " + outputFile + ".";
-        std::cerr << std::endl;
-        return EXIT_FAILURE;
-      }
-      out << A.description();
-      out.close();
-      if (out.fail()) {
-        std::cerr << "Failed to close file " + outputFile + ".";
-        std::cerr << std::endl;
-      }
+      //The file is only opened once the automaton is known to exist, an existing file is kept otherwise
+      omalg::FileAutomatonSink sink(outputFile);
+      S->toWeakBuechi(sink);
     }
     return 0;
   }
+  catch (omalg::OpenFailedException const&) {
+    std::cerr << "Failed to open file " + outputFile + ".";
+    std::cerr << std::endl;
+    return EXIT_FAILURE;
+  }
+  catch (omalg::CloseFailedException const&) {
+    std::cerr << "Failed to close file " + outputFile + ".";
+    std::cerr << std::endl;
+    return EXIT_FAILURE;
+  }
+  catch (omalg::IOException const &e) {
+    std::cerr << "Error: failed to write automaton";
+    std::cerr << std::endl;
+    std::cerr << e.what();
+    std::cerr << std::endl;
+    return EXIT_FAILURE;
+  }
   catch (omalg::OperationNotApplicableException const& e) {
     std::cerr << "Given omega semigroup can not be transformed into equivalent weak Buechi automaton." ;
     std::cerr << std::endl;
@@ -1,13 +1,19 @@
 #ifndef OMALG_PARITY_AUTOMATON_CONVERTER
 #define OMALG_PARITY_AUTOMATON_CONVERTER
 
-#include <list>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
+#include "AutomatonSink.h"
 #include "OmegaSemigroup.h"
 #include "DeterministicParityAutomaton.h"
 #include "DeterministicCoBuechiAutomaton.h"
 #include "DeterministicBuechiAutomaton.h"
+#include "NondeterministicBuechiAutomaton.h"
 
 namespace omalg {
 
@@ -15,25 +21,44 @@ namespace omalg {
    * Utility class to transform given omega semigroup into equivalent automata.
    */
   class AutomatonConverter {
+    friend class ImplicitParityAutomaton;
   public:
     /**
-     * Constructor.
+     * Constructor. The converter keeps a reference to the omega semigroup, which has to outlive it.
      * @param S the input omega semigroup.
+     * @param theComplement whether to convert for the complement language, i.e. with P inverted.
+     * @param theThreads number of threads for the state exploration of the parity and coBuechi
+     *        constructions, 0 for one per hardware thread. The result does not depend on it.
      */
-    AutomatonConverter(OmegaSemigroup const &theS);
+    AutomatonConverter(OmegaSemigroup const &theS, bool theComplement = false, unsigned theThreads = 1);
 
     /**
-     * Execute conversion to parity automaton.
+     * Execute conversion to parity automaton. The states are explored level by level in breadth first order.
+     * Each level is expanded in chunks of bounded size: the successors of a chunk are computed in parallel and
+     * then numbered in order of state and letter, so the states are numbered as in a sequential breadth first search.
      * @return The resulting parity automaton.
      */
     DeterministicParityAutomaton convertToParity() const;
 
     /**
-     * Execute conversion to coBuechi automaton.
+     * Execute conversion to parity automaton, passing the result to a sink instead of building the automaton.
+     * The transitions of each state are released once they are passed on.
+     * @param sink the sink receiving the automaton.
+     */
+    void convertToParity(AutomatonSink& sink) const;
+
+    /**
+     * Execute conversion to coBuechi automaton. The states are explored as for the parity automaton.
      * @return The resulting coBuechi automaton.
      */
     DeterministicCoBuechiAutomaton convertToCoBuechi() const;
 
+    /**
+     * Execute conversion to coBuechi automaton, passing the result to a sink.
+     * @param sink the sink receiving the automaton.
+     */
+    void convertToCoBuechi(AutomatonSink& sink) const;
+
     /**
      * Execute conversion to det. Buechi automaton.
      * @return The resulting det. Buechi automaton.
@@ -41,68 +66,299 @@ namespace omalg {
     DeterministicBuechiAutomaton convertToDetBuechi() const;
 
     /**
-     * Execute conversion to weak Buechi automaton.
+     * Execute conversion to det. Buechi automaton, passing the result to a sink.
+     * @param sink the sink receiving the automaton.
+     */
+    void convertToDetBuechi(AutomatonSink& sink) const;
+
+    /**
+     * Execute conversion to weak Buechi automaton. Only the elements reachable from the initial state by
+     * letter images become states.
      * @return The resulting weak Buechi automaton.
      */
     DeterministicBuechiAutomaton convertToWeakBuechi() const;
+
+    /**
+     * Execute conversion to weak Buechi automaton, passing the result to a sink.
+     * @param sink the sink receiving the automaton.
+     */
+    void convertToWeakBuechi(AutomatonSink& sink) const;
+
+    /**
+     * Execute conversion to nondet. Buechi automaton. The automaton reads a prefix while tracking its image
+     * in sPlus, guesses an accepting linked pair (s,e) when the image is s, and then reads factors with image e,
+     * visiting a final state after each of them. Only states reachable from the initial state and from which
+     * a final state is reachable are kept.
+     * @param reduce whether to reduce the automaton by direct simulation, which is quadratic in the states.
+     * @return The resulting nondet. Buechi automaton.
+     */
+    NondeterministicBuechiAutomaton convertToNondeterministicBuechi(bool reduce = false) const;
+
+    /**
+     * Execute several conversions at once, each passing its result to its own sink. The tables shared by the
+     * constructions are calculated once, then the conversions run concurrently, one thread each. The threads of
+     * the converter are split evenly among the state explorations of the conversions, each getting at least one.
+     * Recognizability is not checked.
+     * @param weakBuechi sink for the weak Buechi automaton, or nullptr to skip it.
+     * @param coBuechi sink for the coBuechi automaton, or nullptr to skip it.
+     * @param detBuechi sink for the det. Buechi automaton, or nullptr to skip it.
+     * @param parity sink for the parity automaton, or nullptr to skip it.
+     */
+    void convertToAll(AutomatonSink* weakBuechi, AutomatonSink* coBuechi, AutomatonSink* detBuechi, AutomatonSink* parity) const;
   private:
     /**
-     * The omega semigroup to transform. No method changes the state of the omega semigroup.
-     * It is declared mutable to implement the conversion to det. Buechi more efficiently,
-     * relying on the coBuechi conversion of the complement.
+     * Interned states of the converters. A state is a sequence of at most width elements of sPlus, stored
+     * as a fixed-width row padded with an unused index. Rows are found by open addressing on their hash,
+     * so each distinct state is stored once and identified by its id, in order of creation.
+     */
+    class StateTable {
+    public:
+      /**
+       * Creates an empty table.
+       * @param theWidth maximal length of a state.
+       * @param thePadding index not used by any element, for padding rows.
+       */
+      StateTable(size_t theWidth, size_t thePadding);
+
+      /**
+       * Looks up a state, adding it if it is new.
+       * @param state the elements of the state.
+       * @param created set to true iff the state was added.
+       * @return the id of the state.
+       */
+      size_t intern(std::vector<size_t> const& state, bool& created);
+
+      /**
+       * Copies the elements of a state.
+       * @param id the id of the state.
+       * @param state replaced by the elements of the state.
+       */
+      void get(size_t id, std::vector<size_t>& state) const;
+
+      /**
+       * Returns the number of states.
+       */
+      size_t size() const;
+
+    private:
+      size_t width;
+      size_t padding;
+      //Rows of all states, row-major.
+      std::vector<size_t> rows;
+      std::vector<size_t> hashes;
+      //Hash slots, holding id + 1 or 0 if empty. The size is a power of two.
+      std::vector<size_t> slots;
+
+      size_t hash(std::vector<size_t> const& state) const;
+      bool equal(size_t id, std::vector<size_t> const& state) const;
+      void insertSlot(size_t id);
+    };
+
+    /**
+     * The omega semigroup to transform.
      */
-    mutable OmegaSemigroup S;
+    OmegaSemigroup const& S;
     /**
-     * Turns list of integers into a string as key for use in maps.
+     * Polarity: if set, the complement of P is used as accepting set.
      */
-    std::string stringValue(std::list<size_t> const& L) const;
+    bool complement;
+    /**
+     * Number of threads for the state exploration.
+     */
+    unsigned threads;
 
+    /**
+     * Once flags of the tables below, so a converter may be shared by several threads. Held by pointer, so
+     * the converter stays movable.
+     */
+    struct TableFlags {
+      std::once_flag tablesFlag, subLoopTablesFlag;
+    };
+    std::unique_ptr<TableFlags> flags;
+
+    /**
+     * Tables for the state constructions, filled by calculateTables. strictExtension[s * n + t] is true iff
+     * s <_J t strictly and s R st, i.e. iff t extends a chain ending in s. rIdempotent[s] is the least
+     * idempotent R equivalent to s, or n if the R class of s is not regular.
+     */
+    mutable std::vector<bool> strictExtension;
+    mutable std::vector<size_t> rIdempotent;
+
+    /**
+     * Calculates the Green relations of sPlus and the tables above, once. O(n^2 + n * |E|) for idempotents E.
+     */
+    void calculateTables() const;
+
+    /**
+     * Takes over the tables above from another converter for the same omega semigroup, unless they are
+     * already calculated. The tables of the other converter are calculated first if necessary.
+     * @param converter the converter to copy the tables from.
+     */
+    void copyTables(AutomatonConverter const& converter) const;
+
+    /**
+     * Sub loop acceptance tables of the coBuechi construction, filled by calculateSubLoopTables.
+     * subLoopTable[t] is subLoopAccepting(t). The values of subLoopAccepting(s, t) are memoized in two bits
+     * at position s * n + t of subLoopPairs: a known bit, followed by the value. The words are atomic, as
+     * the pairs are memoized concurrently during the state exploration.
+     */
+    mutable std::vector<bool> subLoopTable;
+    mutable std::vector<std::atomic<uint64_t> > subLoopPairs;
+
+    /**
+     * Calculates the tables of calculateTables and subLoopTable, once, with no memoized pairs.
+     * O(n^2 + n * L) for L linked pairs.
+     */
+    void calculateSubLoopTables() const;
+
+    /**
+     * Constructions of the conversions. Each fills the state names, transitions and acceptance of the
+     * minimized automaton, with initial state 0.
+     * @param stateNames replaced by the state names.
+     * @param transitionTable replaced by the transitions.
+     * @param priorities replaced by the priorities, respectively finalStates by the final flags.
+     */
+    void buildParity(std::vector<std::string>& stateNames, std::vector<std::vector<size_t> >& transitionTable,
+                     std::vector<size_t>& priorities) const;
+    void buildCoBuechi(std::vector<std::string>& stateNames, std::vector<std::vector<size_t> >& transitionTable,
+                       std::vector<bool>& finalStates) const;
+    void buildWeakBuechi(std::vector<std::string>& stateNames, std::vector<std::vector<size_t> >& transitionTable,
+                         std::vector<bool>& finalStates) const;
+
+    /**
+     * Passes the dual of the coBuechi automaton to a sink, which is a det. Buechi automaton for the complement.
+     * @param sink the sink receiving the automaton.
+     */
+    void convertToDualBuechi(AutomatonSink& sink) const;
+
+    /**
+     * Starts an automaton with initial state 0 in a sink and passes its transitions. The state names and
+     * transitions are released on the way.
+     * @param sink the sink.
+     * @param type the acceptance type.
+     * @param stateNames the state names, cleared.
+     * @param transitionTable the transitions, whose rows are cleared.
+     */
+    void emitTransitions(AutomatonSink& sink, std::string const& type, std::vector<std::string>& stateNames,
+                         std::vector<std::vector<size_t> >& transitionTable) const;
+
+    /**
+     * Membership of an omega element in the accepting set, with respect to the polarity.
+     */
+    bool accepting(size_t omegaElement) const;
     /**
      * Calculate successor state in parity automaton given current state and new rightmost element.
-     * @param currentState list representation of the current state.
+     * @param state the current state, replaced by the successor state.
+     * @param prefix products of the first 1, 2, ... elements of the state, updated along with the state.
      * @param element new rightmost element.
-     * @return list representation of successor state.
      */
-    std::list<size_t> successorState(std::list<size_t> currentState, size_t element) const;
+    void successorState(std::vector<size_t>& state, std::vector<size_t>& prefix, size_t element) const;
 
     /**
      * Calculate priority of a given state.
-     * @param state list representation of the state.
+     * @param state the elements of the state.
+     * @param prefix products of the first 1, 2, ... elements of the state.
      * @return the priority of the state.
      */
-    size_t calculatePriority(std::list<size_t> const &state) const;
+    size_t calculatePriority(std::vector<size_t> const& state, std::vector<size_t> const& prefix) const;
+
+    /**
+     * Reassigns priorities of a deterministic parity automaton, such that the least number of priorities is
+     * used (Carton, Maceiras). In each strongly connected component, the states of maximal priority get the
+     * least priority of the same parity which is at least the priorities assigned recursively to the rest of
+     * the component. For deterministic automata this gives the parity index of the language.
+     * @param transitionTable the transitions of the automaton.
+     * @param priorities the priorities, which are replaced.
+     */
+    void minimizePriorities(std::vector<std::vector<size_t> > const& transitionTable, std::vector<size_t>& priorities) const;
+
+    /**
+     * Recursive step of minimizePriorities for the subgraph induced by the given states.
+     * @param states the states of the subgraph.
+     * @param transitionTable the transitions of the automaton.
+     * @param priorities the original priorities.
+     * @param newPriorities the new priorities, set for all states in a cycle of the subgraph.
+     * @param assigned marks states with a new priority.
+     * @return 1 + the largest new priority in the subgraph, or 0 if the subgraph has no cycle.
+     */
+    size_t minimizePriorities(std::vector<size_t> const& states, std::vector<std::vector<size_t> > const& transitionTable,
+                              std::vector<size_t> const& priorities, std::vector<size_t>& newPriorities,
+                              std::vector<bool>& assigned) const;
+
+    /**
+     * Marks the states of a deterministic automaton which lie on a cycle. The acceptance label of the other
+     * states does not matter.
+     * @param transitionTable the transitions of the automaton.
+     * @return true for each state on a cycle.
+     */
+    std::vector<bool> statesOnCycles(std::vector<std::vector<size_t> > const& transitionTable) const;
+
+    /**
+     * Computes the direct simulation preorder of a nondet. Buechi automaton: q simulates p iff q is final if p
+     * is, and each transition of p is matched by a transition of q with the same letter to a state simulating
+     * the target. Greatest fixed point, iterated from the pairs respecting finality.
+     * @param transitionRelation the transitions of the automaton.
+     * @param finalStates the final flags.
+     * @return entry p * n + q is true iff q simulates p.
+     */
+    std::vector<bool> directSimulation(std::vector<std::vector<std::set<size_t> > > const& transitionRelation,
+                                       std::vector<bool> const& finalStates) const;
+
+    /**
+     * Reduces a nondet. Buechi automaton by direct simulation. Transitions to a state strictly simulated by
+     * another target of the same state and letter are removed, then simulation equivalent states are merged.
+     * Both preserve the language. The states of the result are numbered in breadth first order.
+     * @param transitionRelation the transitions, replaced by those of the result.
+     * @param finalStates the final flags, replaced by those of the result.
+     * @param initial the initial state, which becomes state 0.
+     * @return for each state of the result, a state of the input which it contains.
+     */
+    std::vector<size_t> reduceBySimulation(std::vector<std::vector<std::set<size_t> > >& transitionRelation,
+                                           std::vector<bool>& finalStates, size_t initial) const;
+
+    /**
+     * Merges equivalent states of a deterministic automaton and drops unreachable ones. Two states are
+     * merged iff they are in the same block of the coarsest partition that separates different labels and
+     * is stable under all letters, see refinePartition. The states of the result are numbered in breadth
+     * first order, starting with the initial state 0.
+     * @param transitionTable the transitions, replaced by those of the result.
+     * @param labels the acceptance label of each state.
+     * @param initial the initial state.
+     * @return for each state of the result, a state of the input which it contains.
+     */
+    std::vector<size_t> minimizeStates(std::vector<std::vector<size_t> >& transitionTable, std::vector<size_t> const& labels,
+                                       size_t initial) const;
 
     /**
      * Assign name to a state.
-     * @param state list representation of the state.
+     * @param state the elements of the state.
      * @return a string representation of the state.
      */
-    std::string stateName(std::list<size_t> const &state) const;
+    std::string stateName(std::vector<size_t> const& state) const;
 
     /**
      * Calculate successor state in coBuechi automaton given current state and new rightmost element.
-     * @param currentState list representation of the current state.
+     * @param state the current state, replaced by the successor state.
      * @param element new rightmost element.
-     * @return list representation of successor state.
      */
-    std::list<size_t> CBAsuccessorState(std::list<size_t> const& currentState, size_t element) const;
+    void CBAsuccessorState(std::vector<size_t>& state, size_t element) const;
 
     /**
      * Decide whether a given coBuechi state should be final.
-     * @param state list representation of the state.
+     * @param state the elements of the state.
      * @return true iff the state is final.
      */
-    bool decideFinality(std::list<size_t> const &state) const;
+    bool decideFinality(std::vector<size_t> const& state) const;
 
     /**
-     * Decide whether a given element is sub loop accepting.
+     * Decide whether a given element is sub loop accepting. Requires calculateSubLoopTables.
      * @param t the element to consider.
      * @return true iff t is sub loop accepting.
      */
     bool subLoopAccepting(size_t t) const;
 
     /**
-     * Decide whether a given pair is sub loop accepting.
+     * Decide whether a given pair is sub loop accepting. Requires calculateSubLoopTables, the result is memoized.
      * @param s first element of the pair.
      * @param t second element of the pair
      * @return true iff (s,t) is sub loop accepting.
@@ -0,0 +1,135 @@
+#ifndef OMALG_AUTOMATON_SINK
+#define OMALG_AUTOMATON_SINK
+
+#include <cstddef>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace omalg {
+
+  /**
+   * Receiver for deterministic automata emitted by the converters, see AutomatonConverter. The parts are
+   * passed in the order of the omalg format: begin, then the transitions of each state in order of state id,
+   * then the acceptance of each state in order of state id, and finally end.
+   */
+  class AutomatonSink {
+  public:
+    virtual ~AutomatonSink() {}
+
+    /**
+     * Starts an automaton.
+     * @param type the acceptance type, as in the first line of the omalg format, e.g. "Parity".
+     * @param stateNames the state names, in order of state id.
+     * @param initialState the id of the initial state.
+     * @param alphabet the letters.
+     */
+    virtual void begin(std::string const& type, std::vector<std::string> const& stateNames, size_t initialState,
+                       std::vector<std::string> const& alphabet) = 0;
+
+    /**
+     * Passes the transitions of the next state.
+     * @param state the id of the state.
+     * @param targets the target state for each letter.
+     */
+    virtual void transitions(size_t state, std::vector<size_t> const& targets) = 0;
+
+    /**
+     * Passes the priority of the next state of a parity automaton.
+     * @param state the id of the state.
+     * @param priority the priority of the state.
+     */
+    virtual void priority(size_t state, size_t priority) = 0;
+
+    /**
+     * Passes the final flag of the next state of a Buechi or coBuechi automaton.
+     * @param state the id of the state.
+     * @param isFinal whether the state is final.
+     */
+    virtual void finalState(size_t state, bool isFinal) = 0;
+
+    /**
+     * Finishes the automaton.
+     */
+    virtual void end() = 0;
+  };
+
+  /**
+   * Sink writing the automaton to an output stream in the omalg format, as the description of the automaton.
+   * Only the state names are kept, the transitions are written as they arrive.
+   */
+  class StreamAutomatonSink: public AutomatonSink {
+  private:
+    std::ostream& out;
+    std::vector<std::string> stateNames;
+    std::vector<std::string> alphabet;
+    //Progress, for the separators: whether transitions and the acceptance line were started, and the
+    //number of acceptance entries written.
+    bool transitionsStarted;
+    bool acceptanceStarted;
+    size_t acceptanceEntries;
+
+    /**
+     * Writes the separator before the next acceptance entry, starting the acceptance line if necessary.
+     */
+    void startAcceptanceEntry();
+
+  public:
+    /**
+     * Constructor.
+     * @param theOut the stream to write to, which has to outlive the sink.
+     */
+    StreamAutomatonSink(std::ostream& theOut);
+
+    virtual void begin(std::string const& type, std::vector<std::string> const& theStateNames, size_t initialState,
+                       std::vector<std::string> const& theAlphabet) override;
+    virtual void transitions(size_t state, std::vector<size_t> const& targets) override;
+    virtual void priority(size_t state, size_t priority) override;
+    virtual void finalState(size_t state, bool isFinal) override;
+
+    /**
+     * Finishes the automaton.
+     * @throws WriteFailedException if writing to the stream failed.
+     */
+    virtual void end() override;
+  };
+
+  /**
+   * Sink writing the automaton to a file in the omalg format. The file is only opened, and so truncated, when
+   * the automaton begins. If nothing is passed to the sink, an existing file is left untouched.
+   */
+  class FileAutomatonSink: public AutomatonSink {
+  private:
+    std::string fileName;
+    std::ofstream out;
+    StreamAutomatonSink sink;
+
+  public:
+    /**
+     * Constructor. The file is not opened yet.
+     * @param theFileName the path of the file to write to.
+     */
+    FileAutomatonSink(std::string const& theFileName);
+
+    /**
+     * Opens the file and starts the automaton.
+     * @throws OpenFailedException if the file could not be opened.
+     */
+    virtual void begin(std::string const& type, std::vector<std::string> const& stateNames, size_t initialState,
+                       std::vector<std::string> const& alphabet) override;
+    virtual void transitions(size_t state, std::vector<size_t> const& targets) override;
+    virtual void priority(size_t state, size_t priority) override;
+    virtual void finalState(size_t state, bool isFinal) override;
+
+    /**
+     * Finishes the automaton and closes the file.
+     * @throws WriteFailedException if writing to the file failed.
+     * @throws CloseFailedException if the file could not be closed.
+     */
+    virtual void end() override;
+  };
+
+}
+
+#endif
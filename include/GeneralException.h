@@ -20,6 +20,12 @@ namespace omalg {
     }
   };
 
+  class TableTooLargeException: public std::exception {
+    const char* what() const noexcept override {
+      return "Table indices do not fit into 32 bits.";
+    }
+  };
+
 }
 
 #endif
@@ -24,7 +24,7 @@ namespace omalg {
     void operator=(IOHandler const &) = delete;
 
 	  OmegaAutomaton* readAutomatonFromStream(std::istream &in);
-	  OmegaSemigroup* readOmegaSemigroupFromStream(std::istream &in);
+	  OmegaSemigroup* readOmegaSemigroupFromStream(std::istream &in, bool validate);
 
 	  void writeAutomatonToStream(OmegaAutomaton const &A, std::ostream &out);
 	  void writeOmegaSemigroupToStream(OmegaSemigroup const &S, std::ostream &out);
@@ -82,21 +82,25 @@ namespace omalg {
 	  /**
 	   * Reads omega semigroup from a text file in the omalg format.
 	   * @param inputFileName The name of the input file.
+	   * @param validate Whether to check the omega semigroup axioms, see OmegaSemigroup::axiomViolation.
 	   * @return A pointer to the read omega semigroup.
 	   * @throws OpenFailedException if opening the file fails.
 	   * @throws CloseFailedException if closing the file fails, but no exception occurred before while reading.
 	   * @throws SyntaxException if a syntax error is encountered while reading the file.
 	   * @throws ReadFailedException if an error occurs while reading a line from the file.
+	   * @throws AxiomViolationException if validation is enabled and an axiom does not hold.
 	   */
-	  OmegaSemigroup* readOmegaSemigroupFromFile(std::string inputFileName);
+	  OmegaSemigroup* readOmegaSemigroupFromFile(std::string inputFileName, bool validate = true);
 
 	  /**
 	   * Reads omega semigroup from stdin in the omalg format.
+	   * @param validate Whether to check the omega semigroup axioms, see OmegaSemigroup::axiomViolation.
 	   * @return A pointer to the read omega semigroup.
 	   * @throws SyntaxException if a syntax error is encountered while reading the file.
 	   * @throws ReadFailedException if an error occurs while reading a line from the file.
+	   * @throws AxiomViolationException if validation is enabled and an axiom does not hold.
 	   */
-	  OmegaSemigroup* readOmegaSemigroupFromStdin();
+	  OmegaSemigroup* readOmegaSemigroupFromStdin(bool validate = true);
 
 	  void writeAutomatonToStdout(OmegaAutomaton const &A);
 	  void writeAutomatonToFile(OmegaAutomaton const &A, std::string outputFileName);
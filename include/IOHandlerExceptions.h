@@ -74,6 +74,18 @@ namespace omalg {
     }
   };
 
+  class AxiomViolationException: public IOException {
+  private:
+    std::string message;
+  public:
+    AxiomViolationException(std::string theHintText)
+      : message("Input is not an omega semigroup.\n" + theHintText) {}
+
+    const char* what() const noexcept override {
+      return this->message.c_str();
+    }
+  };
+
 }
 
 #endif
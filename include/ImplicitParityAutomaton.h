@@ -0,0 +1,86 @@
+#ifndef OMALG_IMPLICIT_PARITY_AUTOMATON
+#define OMALG_IMPLICIT_PARITY_AUTOMATON
+
+#include <string>
+#include <vector>
+
+#include "AutomatonConverter.h"
+#include "OmegaSemigroup.h"
+
+namespace omalg {
+
+  /**
+   * Parity automaton of Colcombet's construction for an omega semigroup, computed on the fly. Nothing is
+   * explored in advance: states are the J chains of AutomatonConverter::convertToParity, and successors and
+   * priorities are computed when asked for. Unlike the result of convertToParity, states are not merged and
+   * the priorities are not minimized, as both need the whole automaton.
+   * States are their chains of at most J depth + 1 elements, so no state table is kept and the memory used
+   * does not grow with the number of states explored. All queries may be made concurrently without locking.
+   */
+  class ImplicitParityAutomaton {
+  public:
+    /**
+     * A state: the elements of its chain, which are strictly decreasing in the J order.
+     */
+    typedef std::vector<size_t> State;
+
+    /**
+     * Constructor. The automaton keeps a reference to the omega semigroup, which has to outlive it. The
+     * Green relations of sPlus and the chain tables are calculated here.
+     * @param theS the omega semigroup.
+     */
+    ImplicitParityAutomaton(OmegaSemigroup const& theS);
+
+    /**
+     * Returns the initial state, the empty chain.
+     */
+    State initial() const;
+
+    /**
+     * Computes the successor of a state.
+     * @param state the state.
+     * @param letter the index of an alphabet letter.
+     * @return the successor state.
+     */
+    State successor(State const& state, size_t letter) const;
+
+    /**
+     * Computes the priority of a state. The priority of the initial state, which is on no cycle, is 0.
+     * @param state the state.
+     * @return the priority, such that a run is accepting iff the largest priority seen infinitely often is even.
+     */
+    size_t priority(State const& state) const;
+
+    /**
+     * Returns the name of a state, as in the result of convertToParity.
+     */
+    std::string stateName(State const& state) const;
+
+    /**
+     * Returns the alphabet.
+     */
+    std::vector<std::string> getAlphabet() const;
+
+    /**
+     * Returns the size of the alphabet.
+     */
+    size_t alphabetSize() const;
+
+  private:
+    OmegaSemigroup const& S;
+    AutomatonConverter converter;
+    //Maximal length of a chain.
+    size_t width;
+
+    ImplicitParityAutomaton(ImplicitParityAutomaton const &) = delete;
+    void operator=(ImplicitParityAutomaton const &) = delete;
+
+    /**
+     * Computes the products of the first 1, 2, ... elements of a state.
+     */
+    std::vector<size_t> prefixProducts(State const& state) const;
+  };
+
+}
+
+#endif
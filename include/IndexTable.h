@@ -0,0 +1,125 @@
+#ifndef OMALG_INDEX_TABLE
+#define OMALG_INDEX_TABLE
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace omalg {
+
+  /**
+   * Table of element indices, stored row-major in one contiguous buffer. The width of the entries
+   * (1, 2 or 4 bytes) is chosen at construction from an upper bound on the stored indices. One
+   * dimensional tables are stored as a single row and can be accessed with operator[].
+   */
+  class IndexTable {
+  private:
+    size_t rows;
+    size_t columns;
+    //Bytes per entry. Only the buffer of matching width is used.
+    size_t width;
+    std::vector<uint8_t> narrowEntries;
+    std::vector<uint16_t> mediumEntries;
+    std::vector<uint32_t> wideEntries;
+
+    /**
+     * Allocates the buffer for the given dimensions, with all entries 0.
+     * @param bound Strict upper bound for the indices to be stored.
+     * @throws TableTooLargeException if the indices do not fit into 4 bytes.
+     */
+    void allocate(size_t bound);
+
+  public:
+    /**
+     * Creates an empty table.
+     */
+    IndexTable();
+
+    /**
+     * Creates a table with all entries 0.
+     * @param theRows Number of rows.
+     * @param theColumns Number of columns.
+     * @param bound Strict upper bound for the indices to be stored.
+     */
+    IndexTable(size_t theRows, size_t theColumns, size_t bound);
+
+    /**
+     * Creates a table from nested vectors. All rows must have the same length.
+     * @param table The table entries.
+     * @param bound Strict upper bound for the entries.
+     */
+    IndexTable(std::vector<std::vector<size_t> > const& table, size_t bound);
+
+    /**
+     * Creates a table with one row.
+     * @param values The table entries.
+     * @param bound Strict upper bound for the entries.
+     */
+    IndexTable(std::vector<size_t> const& values, size_t bound);
+
+    /**
+     * Entry access(No check of bounds).
+     * @param row The row.
+     * @param column The column.
+     * @return The entry.
+     */
+    size_t operator()(size_t row, size_t column) const;
+
+    /**
+     * Access to the entry at a position of the row-major buffer(No check of bounds).
+     * For one row tables, this is the entry in the given column.
+     * @param position Position in the buffer.
+     * @return The entry.
+     */
+    size_t operator[](size_t position) const;
+
+    /**
+     * Access to the entry at a position of the row-major buffer. Bounds are checked.
+     * @param position Position in the buffer.
+     * @return The entry.
+     * @throw out_of_range if position is too large.
+     */
+    size_t at(size_t position) const;
+
+    /**
+     * Sets an entry(No check of bounds). The value must be smaller than the bound given at construction.
+     * @param row The row.
+     * @param column The column.
+     * @param value The new entry.
+     */
+    void set(size_t row, size_t column, size_t value);
+
+    /**
+     * Returns the number of rows.
+     */
+    size_t rowCount() const;
+
+    /**
+     * Returns the number of columns.
+     */
+    size_t columnCount() const;
+
+    /**
+     * Returns the number of bytes used per entry.
+     */
+    size_t bytesPerEntry() const;
+  };
+
+  inline size_t IndexTable::operator()(size_t row, size_t column) const {
+    return (*this)[row * this->columns + column];
+  }
+
+  inline size_t IndexTable::operator[](size_t position) const {
+    switch (this->width) {
+    case 1:
+      return this->narrowEntries[position];
+    case 2:
+      return this->mediumEntries[position];
+    default:
+      return this->wideEntries[position];
+    }
+  }
+
+}
+
+#endif
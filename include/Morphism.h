@@ -4,11 +4,13 @@
 #include <string>
 #include <vector>
 
+#include "IndexTable.h"
+
 namespace omalg {
 
   class Morphism {
   private:
-    std::vector<size_t> values;
+    IndexTable values;
     std::vector<std::string> alphabet;
   public:
     /**
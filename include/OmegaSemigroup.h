@@ -3,8 +3,11 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <mutex>
 
 #include "Semigroup.h"
+#include "IndexTable.h"
 #include "Morphism.h"
 #include "GeneralException.h"
 
@@ -13,23 +16,80 @@ namespace omalg {
   class DeterministicBuechiAutomaton;
   class DeterministicCoBuechiAutomaton;
 	class DeterministicParityAutomaton;
+  class NondeterministicBuechiAutomaton;
+  class AutomatonSink;
 
   class OmegaSemigroup {
 
-		//The automaton converter can access private fields of the omega semigroup.
+		//The automaton converter and the implicit parity automaton can access private fields of the omega semigroup.
 		friend class AutomatonConverter;
+		friend class ImplicitParityAutomaton;
 
   private:
   	Semigroup sPlus;
   	std::vector<std::string> omegaElementNames;
-  	std::vector<std::vector<size_t> > mixedProductTable;
-  	std::vector<size_t> omegaIterationTable;
+  	//Mixed products with the first omega elements. Holds all columns unless some are derived, see DerivedColumns.
+  	IndexTable mixedProductTable;
+  	IndexTable omegaIterationTable;
   	std::vector<bool> P;
   	Morphism phi;
 
-  	void invertP();
+  	/**
+  	 * Mixed product columns of the omega elements beyond the columns of mixedProductTable. Each such element
+  	 * x has a representative (s, y) with x = s * y, where y has a column in mixedProductTable. The column
+  	 * of x follows from t * x = (ts) * y. It is computed on first access and kept, each column under its own
+  	 * once flag, so concurrent const queries are safe.
+  	 */
+  	struct DerivedColumns {
+  	  std::vector<std::pair<size_t, size_t> > representatives;
+  	  std::unique_ptr<std::once_flag[]> flags;
+  	  std::vector<IndexTable> columns;
+
+  	  DerivedColumns(std::vector<std::pair<size_t, size_t> > const& theRepresentatives);
+  	};
+  	std::unique_ptr<DerivedColumns> derived;
+
+  	/**
+  	 * Returns the mixed product column of a derived omega element, computing it on first access.
+  	 * @param omegaElement Element of sOmega without column in mixedProductTable.
+  	 * @return The column as a table with one row, indexed by the elements of sPlus.
+  	 */
+  	IndexTable const& derivedColumn(size_t omegaElement) const;
+
+  	/**
+  	 * Membership in P, or in its complement.
+  	 * @param omegaElement Element of sOmega.
+  	 * @param complement Whether to consider the complement of P instead.
+  	 * @return True iff the element is accepting with respect to the given polarity.
+  	 */
+  	bool accepting(size_t omegaElement, bool complement) const;
+
+  	/**
+  	 * Deterministic Buechi check for the language or its complement. The complement of a DB language is DC.
+  	 */
+  	bool isDBRecognizable(bool complement) const;
+
+  	/**
+  	 * Decides E and A recognizability on the R order DAG. E is violated iff some R class has an accepting
+  	 * linked pair (t,f) and a rejecting linked pair (s,e) lies in it or below it. The flags are propagated
+  	 * along the right Cayley graph in reverse topological order of its components. O(L + n * |G|) for
+  	 * L linked pairs and a generating set G.
+  	 * @return Bitmask with the flags E and A.
+  	 */
+  	unsigned eaClasses() const;
 
   public:
+  	/**
+  	 * Flags for the classes of the Landweber hierarchy, as returned by landweberClasses.
+  	 */
+  	enum LandweberClass : unsigned {
+  	  DB = 1, //deterministic Buechi
+  	  DC = 2, //coBuechi
+  	  WB = 4, //weak Buechi
+  	  E  = 8,
+  	  A  = 16
+  	};
+
   	/**
   	 * Omega Semigroup Constructor.
   	 * @param theSemigroup Semigroup part of the omega semigroup.
@@ -43,6 +103,37 @@ namespace omalg {
   	               std::vector<std::vector<size_t> > theMixedProductTable, std::vector<size_t> theOmegaIterationTable,
   	               std::vector<bool> theP,                                 Morphism thePhi);
 
+  	/**
+  	 * Omega Semigroup Constructor with derived mixed product columns. Only the columns of the first k omega
+  	 * elements are given, for k the row length of theMixedProductTable. Each further element x is given as
+  	 * s * y for an element s of sPlus and one of the first k omega elements y. Its column is computed on
+  	 * first access.
+  	 * @param theSemigroup Semigroup part of the omega semigroup.
+  	 * @param theOmegaElementNames Names of the elements of S_omega.
+  	 * @param theMixedProductTable Mixed product table restricted to the first k omega elements.
+  	 * @param theRepresentatives Pair (s, y) for each omega element x >= k, with x = s * y and y < k.
+  	 * @param theOmegaIterationTable Table for the omega iteration operation.
+  	 * @param theP Set of "accepting" elements P, represented by bit vector
+  	 * @param thePhi Morphism from a finite alphabet into the omega semigroup
+  	 */
+  	OmegaSemigroup(Semigroup theSemigroup,                                 std::vector<std::string> theOmegaElementNames,
+  	               std::vector<std::vector<size_t> > theMixedProductTable, std::vector<std::pair<size_t, size_t> > theRepresentatives,
+  	               std::vector<size_t> theOmegaIterationTable,             std::vector<bool> theP,
+  	               Morphism thePhi);
+
+  	/**
+  	 * Copy constructor. Derived columns are not copied, the copy computes them again on access.
+  	 * @param S Omega semigroup to be copied
+  	 */
+  	OmegaSemigroup(OmegaSemigroup const& S);
+
+  	/**
+  	 * Copy assignment operator. Derived columns are not copied, the copy computes them again on access.
+  	 * @param S Omega semigroup to be copied
+  	 * @return A copy of the omega semigroup
+  	 */
+  	OmegaSemigroup& operator=(OmegaSemigroup const& S);
+
   	/**
   	 * Finite semigroup product(No check of bounds).
   	 * @param lhs The left factor.
@@ -52,7 +143,8 @@ namespace omalg {
   	size_t product(size_t lhs, size_t rhs) const;
 
   	/**
-  	 * Mixed product of sPlus and sOmega(no check of bounds),
+  	 * Mixed product of sPlus and sOmega(no check of bounds). Computes the column of a derived omega element
+  	 * on first access.
   	 * @param plusElement Element of sPlus.
   	 * @param omegaElement Element of sOmega.
   	 * @return Index of mixed product result.
@@ -67,9 +159,27 @@ namespace omalg {
   	size_t omegaIteration(size_t element) const;
 
 		/**
-		 * Reduces to syntactic omega semigroup. This is very expensive(O(n^5)).
+		 * Reduces to syntactic omega semigroup. See syntacticClasses and syntacticClassesBySignatures for the runtime.
+		 * @param useSignatures Whether to group elements by context signatures instead of partition refinement.
+		 * @param threads Number of threads for the signature computation, 0 for one per hardware thread.
 		 */
-    void reduceToSyntactic();
+    void reduceToSyntactic(bool useSignatures = false, unsigned threads = 0);
+
+    /**
+     * Restricts to the omega semigroup generated by the images of phi. Elements of sPlus which are not
+     * a product of letter images and omega elements which are not of the form s * t^w are removed.
+     * The remaining elements are renumbered compactly, keeping their relative order and names.
+     * Runtime is O(n * |A| + m * |A|) for n finite and m omega elements and alphabet A.
+     */
+    void reduceToGenerated();
+
+    /**
+     * Checks the omega semigroup axioms: associativity of the finite product, s * (t * x) = (st) * x for the
+     * mixed product and s * (ts)^w = (st)^w. All checks are restricted to a generating set G of sPlus, which
+     * is usually just the set of letter images. Runtime O(n^2 * |G| + n * m * |G|).
+     * @return An empty string if all axioms hold, otherwise a description of a violation.
+     */
+    std::string axiomViolation() const;
 
     /**
      * Returns textual description of omega semigroup in OmAlg format.
@@ -77,6 +187,20 @@ namespace omalg {
      */
     std::string description() const;
 
+    /**
+     * Decides all five Landweber classes. The R order and, for each linked pair (s,e), the acceptance bit
+     * of se^w are computed once for DB, DC and WB. E and A are decided together, see eaClasses.
+     * @return Bitmask of the LandweberClass flags of all classes containing the recognized language.
+     */
+    unsigned landweberClasses() const;
+
+    /**
+     * Checks whether sPlus is aperiodic, see Semigroup::isAperiodic. For the syntactic omega semigroup
+     * this holds iff the language is first-order (LTL) definable. O(n * |A|).
+     * @return True iff sPlus has only trivial H classes.
+     */
+    bool isAperiodic() const;
+
     /**
      * Checks whether the recognized language can be accepted by a deterministic Büchi automaton.
      * @return True iff DBA-recognizable
@@ -114,44 +238,120 @@ namespace omalg {
 		 */
     DeterministicBuechiAutomaton toWeakBuechi() const;
 
+		/**
+		 * Writes an equivalent weak Buechi automaton to a sink, if possible. Nothing is passed to the sink if not.
+		 * @param sink The sink receiving the automaton.
+		 * @throw OperationNotApplicableException if recognized language is not weak Buechi recognizable
+		 */
+    void toWeakBuechi(AutomatonSink& sink) const;
+
 		/**
 		 * Turns omega semigroup into equivalent coBuechi automaton, if possible.
+		 * @param threads Number of threads for the state exploration, 0 for one per hardware thread.
 		 * @return Equivalent coBuechi automaton
 		 * @throw OperationNotApplicableException if recognized language is not coBuechi recognizable
 		 */
-		DeterministicCoBuechiAutomaton toCoBuechi() const;
+		DeterministicCoBuechiAutomaton toCoBuechi(unsigned threads = 1) const;
+
+		/**
+		 * Writes an equivalent coBuechi automaton to a sink, if possible. Nothing is passed to the sink if not.
+		 * @param sink The sink receiving the automaton.
+		 * @param threads Number of threads for the state exploration, 0 for one per hardware thread.
+		 * @throw OperationNotApplicableException if recognized language is not coBuechi recognizable
+		 */
+		void toCoBuechi(AutomatonSink& sink, unsigned threads = 1) const;
 
     /**
 		 * Turns omega semigroup into equivalent det. Buechi automaton, if possible.
+		 * @param threads Number of threads for the state exploration, 0 for one per hardware thread.
 		 * @return Equivalent det. Buechi automaton
 		 * @throw OperationNotApplicableException if recognized language is not det. Buechi recognizable
 		 */
-    DeterministicBuechiAutomaton toDetBuechi() const;
+    DeterministicBuechiAutomaton toDetBuechi(unsigned threads = 1) const;
+
+    /**
+		 * Writes an equivalent det. Buechi automaton to a sink, if possible. Nothing is passed to the sink if not.
+		 * @param sink The sink receiving the automaton.
+		 * @param threads Number of threads for the state exploration, 0 for one per hardware thread.
+		 * @throw OperationNotApplicableException if recognized language is not det. Buechi recognizable
+		 */
+    void toDetBuechi(AutomatonSink& sink, unsigned threads = 1) const;
 
     /**
 		 * Turns omega semigroup into equivalent deterministic parity automaton.
+		 * @param threads Number of threads for the state exploration, 0 for one per hardware thread.
 		 * @return Equivalent parity automaton
 		 */
-    DeterministicParityAutomaton toParity() const;
+    DeterministicParityAutomaton toParity(unsigned threads = 1) const;
+
+    /**
+		 * Writes an equivalent deterministic parity automaton to a sink.
+		 * @param sink The sink receiving the automaton.
+		 * @param threads Number of threads for the state exploration, 0 for one per hardware thread.
+		 */
+    void toParity(AutomatonSink& sink, unsigned threads = 1) const;
+
+    /**
+		 * Turns omega semigroup into equivalent nondet. Buechi automaton, built from the accepting linked pairs.
+		 * Only reachable states from which a final state can be reached are kept.
+		 * @param reduce Whether to reduce the automaton by direct simulation, quadratic in the number of states.
+		 * @return Equivalent nondet. Buechi automaton
+		 */
+    NondeterministicBuechiAutomaton toNondeterministicBuechi(bool reduce = false) const;
+
+    /**
+		 * Writes equivalent automata of several kinds at once, each to its own sink. The Landweber classes are
+		 * decided once, and Buechi targets whose class does not contain the language are skipped. The other
+		 * conversions share the invariants of sPlus and run concurrently, see AutomatonConverter::convertToAll.
+		 * @param weakBuechi Sink for the weak Buechi automaton, or nullptr.
+		 * @param coBuechi Sink for the coBuechi automaton, or nullptr.
+		 * @param detBuechi Sink for the det. Buechi automaton, or nullptr.
+		 * @param parity Sink for the parity automaton, or nullptr.
+		 * @param threads Number of threads, split among the state explorations of the conversions, 0 for one per hardware thread.
+		 * @return Bitmask of the LandweberClass flags of the language, see landweberClasses.
+		 */
+    unsigned toAutomata(AutomatonSink* weakBuechi, AutomatonSink* coBuechi, AutomatonSink* detBuechi, AutomatonSink* parity,
+                        unsigned threads = 1) const;
 
   private:
     /**
-     * Check whether two elements of sPlus are syntactically equivalent.
-     * @param lhs the first element.
-     * @param rhs the second element.
-     * @return true iff the elements are equivalent.
+     * Returns the omega elements needed as right factors of mixed products in the syntactic congruence: the
+     * distinct omega iterations, and all omega elements that are not of the form s * u^w.
+     * @param generators A generating set of sPlus.
+     * @return The right factors, omega iterations first.
+     */
+    std::vector<size_t> rightFactors(std::vector<size_t> const& generators) const;
+
+    /**
+     * Computes the syntactic congruence by partition refinement(Hopcroft's algorithm). The elements of sPlus and
+     * sOmega are the states of a deterministic automaton, with left and right multiplication by generators,
+     * omega iteration and mixed products with the right factors as letters. The syntactic congruence is the
+     * coarsest partition that is stable under all letters and separates P from its complement.
+     * Runtime O(k * (n + m) * log(n + m)) for k letters, where k is at most 2|G| + 1 + m for generators G.
+     * @return The class of each element, first those of sPlus, then those of sOmega. Classes of each sort are
+     *         numbered from 0 in order of their least element.
      */
-    bool sPlusEquivalent(size_t lhs, size_t rhs) const;
+    std::vector<size_t> syntacticClasses() const;
 
     /**
-     * Check whether two elements of sOmega are syntactically equivalent.
-     * @param lhs the first element.
-     * @param rhs the second element.
-     * @return true iff the elements are equivalent.
+     * Computes the syntactic congruence by grouping elements with equal context signatures. Two omega elements
+     * are equivalent iff their bit vectors of P membership of s * x for s in S^1 agree, packed into 64 bit
+     * words. Two elements x, y of sPlus are equivalent iff for all t in S^1 the omega classes of xt * z and
+     * yt * z agree for all right factors z, see rightFactors, and those of (xt)^w and (yt)^w agree. These are
+     * compared as class ids of the right profiles of xt. The signatures are computed in parallel.
+     * Runtime O(n * m + n * (n + k)) for k right factors, memory O(n * (n + m)).
+     * @param threads Number of threads, 0 for one per hardware thread.
+     * @return The class of each element, as for syntacticClasses.
      */
-    bool sOmegaEquivalent(size_t lhs, size_t rhs) const;
+    std::vector<size_t> syntacticClassesBySignatures(unsigned threads) const;
   };
 
+  inline size_t OmegaSemigroup::mixedProduct(size_t plusElement, size_t omegaElement) const {
+    if (omegaElement < this->mixedProductTable.columnCount()) {
+      return this->mixedProductTable(plusElement, omegaElement);
+    }
+    return this->derivedColumn(omegaElement)[plusElement];
+  }
 
 }
 
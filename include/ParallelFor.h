@@ -0,0 +1,20 @@
+#ifndef OMALG_PARALLEL_FOR
+#define OMALG_PARALLEL_FOR
+
+#include <cstddef>
+#include <functional>
+
+namespace omalg {
+
+  /**
+   * Runs body on consecutive ranges [begin, end) covering [0, count), one range per thread.
+   * Small counts and a single thread run body directly in the calling thread.
+   * @param count Number of indices.
+   * @param threads Number of threads, 0 for one per hardware thread.
+   * @param body Function called with the bounds of each range.
+   */
+  void parallelFor(size_t count, unsigned threads, std::function<void(size_t, size_t)> const& body);
+
+}
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef OMALG_PARTITION_REFINEMENT
+#define OMALG_PARTITION_REFINEMENT
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace omalg {
+
+  /**
+   * Computes the coarsest partition of the states of a deterministic, possibly partial, transition system
+   * which refines the given labelling and is stable under all letters(Hopcroft's algorithm). Runtime
+   * O(t * log(n) * log(t)) and memory O(n + t) for n states and t defined transitions, independently of the
+   * number of letters.
+   * @param states Number of states.
+   * @param letters Number of letters.
+   * @param transition Sets target to the successor of state under letter and returns true, or returns false
+   *                   if the transition is undefined. Called twice for each letter and state.
+   * @param labels Label of each state. States with different labels are never in the same block.
+   * @return The block of each state. Blocks are numbered from 0 in order of their least state.
+   */
+  std::vector<size_t> refinePartition(size_t states, size_t letters,
+                                      std::function<bool(size_t, size_t, size_t&)> const& transition,
+                                      std::vector<size_t> const& labels);
+
+}
+
+#endif
@@ -4,28 +4,67 @@
 #include <vector>
 #include <string>
 #include <list>
+#include <memory>
+#include <mutex>
+#include <atomic>
+
+#include "IndexTable.h"
 
 namespace omalg {
 
   class Semigroup {
   private:
     std::vector<std::string> elementNames;
-    std::vector<std::vector<size_t> > multiplicationTable;
+    IndexTable multiplicationTable;
+
+    /**
+     * Lazily computed invariants of the semigroup. Each entry is computed at most once, guarded by its
+     * once flag, so that const queries may be issued concurrently from several threads. The ready flags
+     * are set after the respective computation is finished, and allow cheap checks whether a table
+     * can be used.
+     */
+    struct Invariants {
+      //Green orders. Computed by calculateROrder and calculateGreenRelations.
+      std::once_flag rOrderFlag, lOrderFlag, jOrderFlag;
+      std::atomic<bool> rOrderReady, lOrderReady, jOrderReady;
+      std::vector<std::vector<bool> > rOrder, lOrder, jOrder;
+
+      //J depths. Computed by calculateJDepths.
+      std::once_flag jDepthsFlag;
+      std::atomic<bool> jDepthsReady;
+      std::vector<size_t> jDepths;
 
-    //Allow to store pre-computed green relations to increase efficiency in computations.
-    //This is achieved by calling calculateGreenRelations.
-    mutable std::vector<std::vector<bool> >* jOrder = 0;
-    mutable std::vector<std::vector<bool> >* rOrder = 0;
-    mutable std::vector<std::vector<bool> >* lOrder = 0;
+      //Lists of idempotents and linked pairs.
+      std::once_flag idempotentsFlag, linkedPairsFlag;
+      std::atomic<bool> idempotentsReady, linkedPairsReady;
+      std::list<size_t> idempotents;
+      std::list<std::pair<size_t, size_t> > linkedPairs;
 
-    //Allow to store pre-computed j depths to increase efficiency in computations.
-    //This is achieved by calling calculateJDepths.
-    mutable std::vector<size_t>* jDepths = 0;
+      //Power structure. Computed by calculatePowerStructure.
+      std::once_flag powerStructureFlag;
+      std::atomic<bool> powerStructureReady;
+      std::vector<size_t> powerIndices, powerPeriods, idempotentPowers;
 
-    //Lists of idempotents and linked pairs are cached once calculated.
-    //These can not be empty once calculated as every finite semigroup contains an idempotent.
-    mutable std::list<std::pair<size_t, size_t> > _linkedPairs = std::list<std::pair<size_t, size_t> >();
-    mutable std::list<size_t> _idempotents = std::list<size_t>();
+      Invariants();
+    };
+    std::unique_ptr<Invariants> cache;
+
+    /**
+     * Fills the invariants of this semigroup with those already computed for S.
+     * @param S Semigroup with identical product table.
+     */
+    void copyInvariants(Semigroup const& S);
+
+    /**
+     * Calculates only the L order.
+     */
+    void calculateLOrder() const;
+
+    /**
+     * Computes the J depth function. Requires the J order to be calculated.
+     * @return the J depth of each element.
+     */
+    std::vector<size_t> computeJDepths() const;
 
   public:
     /**
@@ -75,7 +114,8 @@ namespace omalg {
     std::vector<std::string> getElementNames() const;
 
     /**
-     * Calculates the R, L, J and orders.
+     * Calculates the R, L, J and orders. This and the other calculate functions may be called concurrently,
+     * each invariant is computed only once.
      */
     void calculateGreenRelations() const;
 
@@ -89,6 +129,13 @@ namespace omalg {
      */
     void calculateJDepths() const;
 
+    /**
+     * Calculates index, period and idempotent power of all elements. For each element x, the powers
+     * x, x^2, ... are followed in the product table until the first repetition. O(n * (i + p)) for
+     * the largest index i and period p.
+     */
+    void calculatePowerStructure() const;
+
     /**
      * Functions for Green equivalence relations. Faster if calculateGreenRelations was executed beforehand.
      */
@@ -112,20 +159,66 @@ namespace omalg {
      */
     size_t jDepth(size_t index) const;
 
+    /**
+     * Returns the index of an element x, the least i such that x^i = x^j for some j > i.
+     * @param index index of the element.
+     * @return The index of x.
+     */
+    size_t powerIndex(size_t index) const;
+
+    /**
+     * Returns the period of an element x, the least p such that x^i = x^(i+p) for the index i of x.
+     * @param index index of the element.
+     * @return The period of x.
+     */
+    size_t powerPeriod(size_t index) const;
+
+    /**
+     * Returns the idempotent power x^pi of an element x, the unique idempotent among the powers of x.
+     * @param index index of the element.
+     * @return Index of the idempotent power.
+     */
+    size_t idempotentPower(size_t index) const;
+
     /**
      * Returns all linked pairs of the semigroup. A linked pair is a tuple (s,e) such that se = s and ee = e.
      * The list is sorted by increasing element id of s. Where s is identical, it is sorted by increasing element id of e.
      * @return A list of all linked pairs.
      */
-    std::list<std::pair<size_t, size_t> > linkedPairs() const;
+    std::list<std::pair<size_t, size_t> > const& linkedPairs() const;
 
     /**
      * Returns a list of all idempotents in the semigroup.
      * The list is sorted by increasing element id.
      * @return A list of all idempotents.
      */
-    std::list<size_t> idempotents() const;
+    std::list<size_t> const& idempotents() const;
 
+    /**
+     * Extends a set of elements to a generating set of the semigroup. While some element is not a product
+     * of the generators so far, the least such element is added and the closure is extended from it. So
+     * only elements not generated by the others are added. O(n * |generators|).
+     * @param elements The elements to start with.
+     * @return The given elements, followed by the added ones in increasing order.
+     */
+    std::vector<size_t> generatingSet(std::vector<size_t> const& elements) const;
+
+    /**
+     * Checks associativity with Light's test restricted to a generating set: the product is associative
+     * iff (x * g) * y = x * (g * y) for all elements x, y and generators g. O(n^2 * |generators|).
+     * @param generators A generating set of the semigroup, see generatingSet.
+     * @return True iff the product is associative.
+     */
+    bool isAssociative(std::vector<size_t> const& generators) const;
+
+    /**
+     * Checks whether the semigroup is aperiodic, i.e. all H classes are trivial. R classes are the strongly
+     * connected components of the right Cayley graph, L classes those of the left one, so neither the
+     * Green orders nor the J classes are needed. O(n * |generators|).
+     * @param generators A generating set of the semigroup, see generatingSet.
+     * @return True iff no two distinct elements are both R and L equivalent.
+     */
+    bool isAperiodic(std::vector<size_t> const& generators) const;
 
     /**
      * Returns textual description of semigroup in OmAlg format.
@@ -134,7 +227,7 @@ namespace omalg {
     std::string description() const;
 
     /**
-     * Destructor, removing matrices for green orders
+     * Destructor.
      */
     ~Semigroup();
   };
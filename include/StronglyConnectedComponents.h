@@ -0,0 +1,19 @@
+#ifndef OMALG_STRONGLY_CONNECTED_COMPONENTS
+#define OMALG_STRONGLY_CONNECTED_COMPONENTS
+
+#include <cstddef>
+#include <vector>
+
+namespace omalg {
+
+  /**
+   * Computes the strongly connected components of a graph (iterative version of Tarjan's algorithm).
+   * Components are numbered in reverse topological order: edges lead to components with smaller or equal index.
+   * @param graph the successors of each node, e.g. a Cayley graph or the transition table of an automaton.
+   * @return for each node, the index of its component.
+   */
+  std::vector<size_t> stronglyConnectedComponents(std::vector<std::vector<size_t> > const& graph);
+
+}
+
+#endif
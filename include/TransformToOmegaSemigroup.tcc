@@ -135,7 +135,7 @@ namespace omalg {
         newName += ")";
         elementNames[columnIndex] = newName;
         //Update table
-        size_t rowIndex = rowBegin;
+        size_t rowIndex = 0;
         for (auto listIter = listBegin; listIter != nodeList.end(); ++listIter) {
           Node<TransitionProfile<T> >* targetNode = *listIter;
           for(auto pathIter = letterList.begin(); pathIter != letterList.end(); ++pathIter) {
@@ -152,20 +152,25 @@ namespace omalg {
     /*
      * Building the omega part.
      */
-    //Omega iteration of semigroup elements.
-    //TODO: This is a bit complicated and might not be the most efficient way.
+    //Omega iteration of semigroup elements. As x^w = (x^pi)^w for the idempotent power x^pi, the
+    //profile operation is only needed for idempotents.
+    std::vector<Node<TransitionProfile<T> >*> nodes(listBegin, typename std::list<Node<TransitionProfile<T> >*>::const_iterator(nodeList.end()));
     std::vector<OmegaProfile> omegaIters(tableSize, std::vector<bool>(tableSize));
-    size_t omegaIndex = 0;
-    for (auto listIter = listBegin; listIter != nodeList.end(); ++listIter) {
-      omegaIters[omegaIndex] = (*listIter)->getValue().omegaIteration();
-      ++omegaIndex;
+    std::vector<bool> iterated(tableSize, false);
+    for (size_t splusIndex = 0; splusIndex < tableSize; ++splusIndex) {
+      size_t idempotent = Splus.idempotentPower(splusIndex);
+      if (!iterated[idempotent]) {
+        omegaIters[idempotent] = nodes[idempotent]->getValue().omegaIteration();
+        iterated[idempotent] = true;
+      }
+      omegaIters[splusIndex] = omegaIters[idempotent];
     }
     //Map of omega profiles to their indices.
     std::unordered_map<OmegaProfile, size_t, OmegaProfileHash> omegaProfiles;
     //List of omega names, will later be turned into vector.
     std::list<std::string> omegaNames;
     //Fill the map with omega iterations.
-    omegaIndex = 0;
+    size_t omegaIndex = 0;
     for (auto vecIter = omegaIters.begin(); vecIter != omegaIters.end(); ++vecIter) {
       if (omegaProfiles.find(*vecIter) == omegaProfiles.end()) {
         omegaProfiles[*vecIter] = omegaIndex;
@@ -175,44 +180,34 @@ namespace omalg {
       }
     }
     size_t boundary = omegaIndex;
-    //Fill the map with all mixed products. Keep partial mixed product table.
-    std::vector<std::vector<size_t> > partialMixedTable(tableSize, std::vector<size_t>(omegaProfiles.size()));
+    //One finite element u for each distinct omega iteration u^w, in order of the omega indices.
+    std::vector<size_t> iterationRepresentatives(boundary);
+    for (size_t splusIndex = tableSize; splusIndex > 0; --splusIndex) {
+      iterationRepresentatives[omegaProfiles[omegaIters[splusIndex - 1]]] = splusIndex - 1;
+    }
+    //Every omega element is of the form s * u^w for some omega iteration u^w. Compute the products s * u^w
+    //for all s and the representatives u. All other mixed products follow from t * (s * u^w) = (ts) * u^w.
+    std::vector<std::vector<size_t> > partialMixedTable(tableSize, std::vector<size_t>(boundary));
+    //Canonical representative (s, u^w) of each omega element with index at least boundary. Their mixed
+    //product columns are derived by the omega semigroup on first access.
+    std::vector<std::pair<size_t, size_t> > omegaRepresentatives;
     for (auto listIter = listBegin; listIter != nodeList.end(); ++listIter) {
-      for (auto vecIter = omegaIters.begin(); vecIter != omegaIters.end(); ++vecIter) {
-        OmegaProfile mixedProduct = (*listIter)->getValue().mixedProduct(*vecIter);
-        if (omegaProfiles.find(mixedProduct) == omegaProfiles.end()) {
-          omegaProfiles[mixedProduct] = omegaIndex;
-          std::string newName = elementNames[(*listIter)->getIndex() - rowOffset] + "(" + elementNames[vecIter - omegaIters.begin()] + ")^w";
+      //Subtract 1 from finite index if epsilon is not in the table
+      size_t finIndex = (*listIter)->getIndex() - rowOffset;
+      for (size_t omIndex = 0; omIndex < boundary; ++omIndex) {
+        size_t representative = iterationRepresentatives[omIndex];
+        OmegaProfile mixedProduct = (*listIter)->getValue().mixedProduct(omegaIters[representative]);
+        auto mapIter = omegaProfiles.find(mixedProduct);
+        if (mapIter == omegaProfiles.end()) {
+          mapIter = omegaProfiles.insert(std::make_pair(mixedProduct, omegaIndex)).first;
+          std::string newName = elementNames[finIndex] + "(" + elementNames[representative] + ")^w";
           omegaNames.insert(omegaNames.end(), newName);
+          omegaRepresentatives.push_back(std::make_pair(finIndex, omIndex));
           ++omegaIndex;
         }
-        //Update mixed table
-        //Subtract 1 from finite index if epsilon is not in the table 
-        size_t finIndex = (*listIter)->getIndex() - rowOffset;
-        size_t omIndex = omegaProfiles[*vecIter];
-        partialMixedTable[finIndex][omIndex] = omegaProfiles[mixedProduct]; 
+        partialMixedTable[finIndex][omIndex] = mapIter->second;
       }
     }
-    //Create real mixed table.
-    std::vector<std::vector<size_t> > mixedTable(tableSize, std::vector<size_t>(omegaProfiles.size()));
-    //Copy values from old table. 
-    for (size_t splusIndex = 0; splusIndex < tableSize; ++splusIndex) {
-      for (size_t somegaIndex = 0; somegaIndex < boundary; ++somegaIndex) {
-        mixedTable[splusIndex][somegaIndex] = partialMixedTable[splusIndex][somegaIndex];
-      }
-    }
-    //Fill rest of mixed table.
-    for (auto mapIter = omegaProfiles.begin(); mapIter != omegaProfiles.end(); ++mapIter) {
-      if (mapIter->second >= boundary) {
-        for (auto listIter = listBegin; listIter != nodeList.end(); ++listIter) {
-          OmegaProfile mixedProduct = (*listIter)->getValue().mixedProduct(mapIter->first);
-          //Subtract 1 from finite index if epsilon is not in the table
-          size_t finIndex = (*listIter)->getIndex() - rowOffset;
-          mixedTable[finIndex][mapIter->second] = omegaProfiles[mixedProduct];
-        }
-      }
-    }
-    
     //Fill omega table.
     std::vector<size_t> omegaTable(tableSize);
     for (size_t splusIndex = 0; splusIndex < tableSize; ++splusIndex) {
@@ -242,7 +237,7 @@ namespace omalg {
     //Turn names from list into vector.
     std::vector<std::string> nameVector(omegaNames.begin(), omegaNames.end());
     //Create omega semigroup.
-    OmegaSemigroup* result = new OmegaSemigroup(Splus, nameVector, mixedTable, omegaTable, P, phi);
+    OmegaSemigroup* result = new OmegaSemigroup(Splus, nameVector, partialMixedTable, omegaRepresentatives, omegaTable, P, phi);
     
     /*
      * Cleanup
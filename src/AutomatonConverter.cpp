@@ -1,263 +1,987 @@
-#include <queue>
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <thread>
 #include <unordered_map>
 
 #include "AutomatonConverter.h"
+#include "ParallelFor.h"
+#include "PartitionRefinement.h"
+#include "StronglyConnectedComponents.h"
 
 namespace omalg {
-  AutomatonConverter::AutomatonConverter(OmegaSemigroup const &theS)
-    : S(theS) { }
+  namespace {
+    //Number of states of a breadth first level expanded at once. Bounds the buffer of successor rows.
+    size_t const levelChunk = 4096;
+  }
 
-  DeterministicParityAutomaton AutomatonConverter::convertToParity() const {
+  AutomatonConverter::AutomatonConverter(OmegaSemigroup const &theS, bool theComplement, unsigned theThreads)
+    : S(theS), complement(theComplement), threads(theThreads), flags(new TableFlags()) { }
+
+  void AutomatonConverter::calculateTables() const {
+    std::call_once(this->flags->tablesFlag, [this]() {
+      this->S.sPlus.calculateGreenRelations();
+      size_t size = this->S.sPlus.size();
+      this->strictExtension.assign(size * size, false);
+      for (size_t s = 0; s < size; ++s) {
+        for (size_t t = 0; t < size; ++t) {
+          this->strictExtension[s * size + t] = this->S.sPlus.j(s, t) && !(this->S.sPlus.j(t, s)) &&
+                                                this->S.sPlus.r(s, this->S.sPlus.product(s, t));
+        }
+      }
+      this->rIdempotent.assign(size, size);
+      auto const& idempotents = this->S.sPlus.idempotents();
+      for (auto iter = idempotents.begin(); iter != idempotents.end(); ++iter) {
+        for (size_t s = 0; s < size; ++s) {
+          if (this->rIdempotent[s] == size && this->S.sPlus.R(s, *iter)) {
+            this->rIdempotent[s] = *iter;
+          }
+        }
+      }
+    });
+  }
+
+  void AutomatonConverter::copyTables(AutomatonConverter const& converter) const {
+    converter.calculateTables();
+    //Running the copy through the once flag marks the tables as calculated.
+    std::call_once(this->flags->tablesFlag, [&]() {
+      this->S.sPlus.calculateGreenRelations();
+      this->strictExtension = converter.strictExtension;
+      this->rIdempotent = converter.rIdempotent;
+    });
+  }
+
+  void AutomatonConverter::calculateSubLoopTables() const {
+    this->calculateTables();
+    std::call_once(this->flags->subLoopTablesFlag, [this]() {
+      size_t size = this->S.sPlus.size();
+      auto const& pairs = this->S.sPlus.linkedPairs();
+      this->subLoopTable.assign(size, true);
+      for (size_t t = 0; t < size; ++t) {
+        size_t e = this->rIdempotent[t];
+        //Regular R class: decided by its idempotent.
+        if (e != size) {
+          this->subLoopTable[t] = this->accepting(this->S.omegaIterationTable[e]);
+          continue;
+        }
+        //R class is irregular -> check above linked pairs (r, f), i.e. t <_j r and tr J t.
+        for (auto iter = pairs.begin(); iter != pairs.end(); ++iter) {
+          size_t r = iter->first;
+          if (this->strictExtension[t * size + r] &&
+              !(this->accepting(this->S.mixedProduct(this->S.sPlus.product(t, r), this->S.omegaIterationTable[iter->second])))) {
+            this->subLoopTable[t] = false;
+            break;
+          }
+        }
+      }
+      //Two bits per pair, all unknown.
+      std::vector<std::atomic<uint64_t> >((size * size + 31) / 32).swap(this->subLoopPairs);
+    });
+  }
+
+  bool AutomatonConverter::accepting(size_t omegaElement) const {
+    return this->S.accepting(omegaElement, this->complement);
+  }
+
+  AutomatonConverter::StateTable::StateTable(size_t theWidth, size_t thePadding)
+    : width(theWidth), padding(thePadding), slots(16, 0) { }
+
+  size_t AutomatonConverter::StateTable::hash(std::vector<size_t> const& state) const {
+    size_t result = state.size();
+    for (auto iter = state.begin(); iter != state.end(); ++iter) {
+      result ^= *iter + 0x9e3779b97f4a7c15ULL + (result << 6) + (result >> 2);
+    }
+    return result;
+  }
+
+  bool AutomatonConverter::StateTable::equal(size_t id, std::vector<size_t> const& state) const {
+    size_t const* row = &this->rows[id * this->width];
+    for (size_t i = 0; i < this->width; ++i) {
+      if (row[i] != (i < state.size() ? state[i] : this->padding)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void AutomatonConverter::StateTable::insertSlot(size_t id) {
+    size_t mask = this->slots.size() - 1;
+    size_t slot = this->hashes[id] & mask;
+    while (this->slots[slot] != 0) {
+      slot = (slot + 1) & mask;
+    }
+    this->slots[slot] = id + 1;
+  }
+
+  size_t AutomatonConverter::StateTable::intern(std::vector<size_t> const& state, bool& created) {
+    size_t stateHash = this->hash(state);
+    size_t mask = this->slots.size() - 1;
+    for (size_t slot = stateHash & mask; this->slots[slot] != 0; slot = (slot + 1) & mask) {
+      size_t id = this->slots[slot] - 1;
+      if (this->hashes[id] == stateHash && this->equal(id, state)) {
+        created = false;
+        return id;
+      }
+    }
+    //New state: append padded row, keep load factor at most 1/2.
+    size_t id = this->hashes.size();
+    this->rows.insert(this->rows.end(), state.begin(), state.end());
+    this->rows.resize((id + 1) * this->width, this->padding);
+    this->hashes.push_back(stateHash);
+    if (2 * (id + 1) > this->slots.size()) {
+      this->slots.assign(2 * this->slots.size(), 0);
+      for (size_t other = 0; other < id; ++other) {
+        this->insertSlot(other);
+      }
+    }
+    this->insertSlot(id);
+    created = true;
+    return id;
+  }
+
+  void AutomatonConverter::StateTable::get(size_t id, std::vector<size_t>& state) const {
+    state.clear();
+    size_t const* row = &this->rows[id * this->width];
+    for (size_t i = 0; i < this->width && row[i] != this->padding; ++i) {
+      state.push_back(row[i]);
+    }
+  }
+
+  size_t AutomatonConverter::StateTable::size() const {
+    return this->hashes.size();
+  }
+
+  void AutomatonConverter::buildParity(std::vector<std::string>& stateNames, std::vector<std::vector<size_t> >& transitionTable,
+                                       std::vector<size_t>& priorities) const {
     //Setup semigroup.
-    this->S.sPlus.calculateGreenRelations();
+    this->calculateTables();
     this->S.sPlus.calculateJDepths();
     //Fetch alphabet size
     auto alphabetSize = this->S.phi.size();
-    //Auto increasing state ID for created states.
-    size_t stateID = 0;
-    //Queue of created states that have yet to be processed for transition specification.
-    //States are inserted only once after creation, in order of ID.
-    auto toCheck = std::queue<std::list<size_t> >();
-    //Map of created states (their string value is the key) to their state id.
-    auto stateMap = std::unordered_map<std::string, size_t>();
-    //List of transition table for each state, in order of state ID.
-    auto transitionList = std::list<std::vector<size_t> >();
-    //List of parities for each state, in order of state ID.
-    auto parityList = std::list<size_t>();
-    //List of state names for each state, in order of state ID.
-    auto stateList = std::list<std::string>();
+    //States are chains strictly increasing in the J order, so their length is bounded by the maximal J depth + 1.
+    size_t pSize = this->S.sPlus.size();
+    size_t width = 1;
+    for (size_t s = 0; s < pSize; ++s) {
+      width = std::max(width, this->S.sPlus.jDepth(s) + 1);
+    }
+    //Created states, with ids in order of creation.
+    auto states = StateTable(width, pSize);
+    //Transition table, parities and state names for each state, in order of state ID.
+    transitionTable.clear();
+    priorities.clear();
+    stateNames.clear();
+    //Successor rows of the states of one chunk of a level, padded as in the state table, in order of state and letter.
+    auto successors = std::vector<size_t>();
 
     //Create initial state (empty list).
-    stateMap[""] = stateID;
-    parityList.push_back(0);
-    stateList.push_back("<>");
-    ++stateID;
-    toCheck.push(std::list<size_t>());
-
-    //main loop
-    while (!toCheck.empty()) {
-      //get next state to process for transitions
-      auto currentState = toCheck.front();
-      toCheck.pop();
-      auto targetVector = std::vector<size_t>(alphabetSize, 0);
-      //Generate successor state for each alphabet letter
-      for (size_t letter = 0; letter < alphabetSize; ++letter) {
-        auto successor = this->successorState(currentState, this->S.phi[letter]);
-        auto successorString = this->stringValue(successor);
-        //If state does not already exist: create new state
-        if (stateMap.find(successorString) == stateMap.end()) {
-          stateMap[successorString] = stateID;
-          parityList.push_back(this->calculatePriority(successor));
-          stateList.push_back(this->stateName(successor));
-          ++stateID;
-          toCheck.push(successor);
+    auto state = std::vector<size_t>();
+    state.reserve(width);
+    bool created = false;
+    states.intern(state, created);
+
+    //main loop: the states of each breadth first level have consecutive ids.
+    for (size_t begin = 0; begin < states.size(); ) {
+      size_t end = states.size();
+      transitionTable.resize(end, std::vector<size_t>(alphabetSize, 0));
+      priorities.resize(end, 0);
+      stateNames.resize(end);
+      //Expand the level chunk by chunk, interning the successors of each chunk in order of state and letter.
+      for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += levelChunk) {
+        size_t chunkEnd = std::min(end, chunkBegin + levelChunk);
+        successors.assign((chunkEnd - chunkBegin) * alphabetSize * width, pSize);
+        //Label the states of the chunk and compute their successors.
+        parallelFor(chunkEnd - chunkBegin, this->threads, [&](size_t first, size_t last) {
+          auto currentState = std::vector<size_t>();
+          auto currentPrefix = std::vector<size_t>();
+          auto successor = std::vector<size_t>();
+          auto prefix = std::vector<size_t>();
+          currentState.reserve(width);
+          currentPrefix.reserve(width);
+          successor.reserve(width);
+          prefix.reserve(width);
+          for (size_t i = first; i < last; ++i) {
+            states.get(chunkBegin + i, currentState);
+            //Prefix products of the current state, computed once for all letters.
+            currentPrefix.clear();
+            for (auto iter = currentState.begin(); iter != currentState.end(); ++iter) {
+              currentPrefix.push_back(currentPrefix.empty() ? *iter : this->S.sPlus.product(currentPrefix.back(), *iter));
+            }
+            if (currentState.empty()) {
+              stateNames[chunkBegin + i] = "<>";
+            }
+            else {
+              priorities[chunkBegin + i] = this->calculatePriority(currentState, currentPrefix);
+              stateNames[chunkBegin + i] = this->stateName(currentState);
+            }
+            //Generate successor state for each alphabet letter
+            for (size_t letter = 0; letter < alphabetSize; ++letter) {
+              successor = currentState;
+              prefix = currentPrefix;
+              this->successorState(successor, prefix, this->S.phi[letter]);
+              std::copy(successor.begin(), successor.end(), successors.begin() + (i * alphabetSize + letter) * width);
+            }
+          }
+        });
+        //Store transitions. Successors which do not already exist form the next level.
+        for (size_t i = 0; i < chunkEnd - chunkBegin; ++i) {
+          for (size_t letter = 0; letter < alphabetSize; ++letter) {
+            auto row = successors.begin() + (i * alphabetSize + letter) * width;
+            state.assign(row, std::find(row, row + width, pSize));
+            transitionTable[chunkBegin + i][letter] = states.intern(state, created);
+          }
         }
-        //Store transition
-        targetVector[letter] = stateMap[successorString];
       }
-      //Push transition to list
-      transitionList.push_back(targetVector);
+      begin = end;
     }
 
-    //Create state name vector
-    auto stateNames = std::vector<std::string>(stateList.begin(), stateList.end());
-    //Create transition table
-    auto transitionTable = std::vector<std::vector<size_t> >(transitionList.begin(), transitionList.end());
-    //Create priority vector
-    auto priorities = std::vector<size_t>(parityList.begin(), parityList.end());
+    //Use as few priorities as possible, then merge states with equal behaviour.
+    this->minimizePriorities(transitionTable, priorities);
+    auto representatives = this->minimizeStates(transitionTable, priorities, 0);
+    auto minimalNames = std::vector<std::string>(representatives.size());
+    auto minimalPriorities = std::vector<size_t>(representatives.size());
+    for (size_t q = 0; q < representatives.size(); ++q) {
+      minimalNames[q] = stateNames[representatives[q]];
+      minimalPriorities[q] = priorities[representatives[q]];
+    }
+    stateNames.swap(minimalNames);
+    priorities.swap(minimalPriorities);
+  }
 
-    //return result
+  DeterministicParityAutomaton AutomatonConverter::convertToParity() const {
+    auto stateNames = std::vector<std::string>();
+    auto transitionTable = std::vector<std::vector<size_t> >();
+    auto priorities = std::vector<size_t>();
+    this->buildParity(stateNames, transitionTable, priorities);
     return DeterministicParityAutomaton(stateNames, this->S.phi.getAlphabet(), 0, transitionTable, priorities);
+  }
 
+  void AutomatonConverter::convertToParity(AutomatonSink& sink) const {
+    auto stateNames = std::vector<std::string>();
+    auto transitionTable = std::vector<std::vector<size_t> >();
+    auto priorities = std::vector<size_t>();
+    this->buildParity(stateNames, transitionTable, priorities);
+    this->emitTransitions(sink, "Parity", stateNames, transitionTable);
+    for (size_t q = 0; q < priorities.size(); ++q) {
+      sink.priority(q, priorities[q]);
+    }
+    sink.end();
   }
 
-  DeterministicCoBuechiAutomaton AutomatonConverter::convertToCoBuechi() const {
-    //Setup semigroup.
-    this->S.sPlus.calculateGreenRelations();
+  void AutomatonConverter::buildCoBuechi(std::vector<std::string>& stateNames, std::vector<std::vector<size_t> >& transitionTable,
+                                         std::vector<bool>& finalStates) const {
+    //Setup semigroup and sub loop acceptance.
+    this->calculateSubLoopTables();
     //Fetch alphabet size
     auto alphabetSize = this->S.phi.size();
-    //Auto increasing state ID for created states.
-    size_t stateID = 0;
-    //Queue of created states that have yet to be processed for transition specification.
-    //States are inserted only once after creation, in order of ID.
-    auto toCheck = std::queue<std::list<size_t> >();
-    //Map of created states (their string value is the key) to their state id.
-    auto stateMap = std::unordered_map<std::string, size_t>();
-    //List of transition table for each state, in order of state ID.
-    auto transitionList = std::list<std::vector<size_t> >();
-    //List of final flag for each state, in order of state ID.
-    auto finalList = std::list<bool>();
-    //List of state names for each state, in order of state ID.
-    auto stateList = std::list<std::string>();
+    //Created states of at most two elements, with ids in order of creation.
+    size_t pSize = this->S.sPlus.size();
+    auto states = StateTable(2, pSize);
+    //Transition table, final flags and state names for each state, in order of state ID.
+    transitionTable.clear();
+    finalStates.clear();
+    stateNames.clear();
+    //Successor rows of the states of one chunk of a level, padded as in the state table, in order of state and letter.
+    auto successors = std::vector<size_t>();
 
     //Create initial state (empty list).
-    stateMap[""] = stateID;
-    finalList.push_back(false);
-    stateList.push_back("<>");
-    ++stateID;
-    toCheck.push(std::list<size_t>());
-
-    //main loop
-    while (!toCheck.empty()) {
-      //get next state to process for transitions
-      auto currentState = toCheck.front();
-      toCheck.pop();
-      auto targetVector = std::vector<size_t>(alphabetSize, 0);
-      //Generate successor state for each alphabet letter
-      for (size_t letter = 0; letter < alphabetSize; ++letter) {
-        auto successor = this->CBAsuccessorState(currentState, this->S.phi[letter]);
-        auto successorString = this->stringValue(successor);
-        //If state does not already exist: create new state
-        if (stateMap.find(successorString) == stateMap.end()) {
-          stateMap[successorString] = stateID;
-          finalList.push_back(this->decideFinality(successor));
-          stateList.push_back(this->stateName(successor));
-          ++stateID;
-          toCheck.push(successor);
+    auto state = std::vector<size_t>();
+    state.reserve(2);
+    bool created = false;
+    states.intern(state, created);
+
+    //main loop: the states of each breadth first level have consecutive ids.
+    for (size_t begin = 0; begin < states.size(); ) {
+      size_t end = states.size();
+      transitionTable.resize(end, std::vector<size_t>(alphabetSize, 0));
+      //Final flags are computed into a byte vector, which may be written concurrently.
+      auto levelFinal = std::vector<char>(end - begin, 0);
+      stateNames.resize(end);
+      //Expand the level chunk by chunk, interning the successors of each chunk in order of state and letter.
+      for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += levelChunk) {
+        size_t chunkEnd = std::min(end, chunkBegin + levelChunk);
+        successors.assign((chunkEnd - chunkBegin) * alphabetSize * 2, pSize);
+        //Label the states of the chunk and compute their successors.
+        parallelFor(chunkEnd - chunkBegin, this->threads, [&](size_t first, size_t last) {
+          auto currentState = std::vector<size_t>();
+          auto successor = std::vector<size_t>();
+          currentState.reserve(2);
+          successor.reserve(2);
+          for (size_t i = first; i < last; ++i) {
+            states.get(chunkBegin + i, currentState);
+            if (currentState.empty()) {
+              stateNames[chunkBegin + i] = "<>";
+            }
+            else {
+              levelFinal[chunkBegin - begin + i] = this->decideFinality(currentState);
+              stateNames[chunkBegin + i] = this->stateName(currentState);
+            }
+            //Generate successor state for each alphabet letter
+            for (size_t letter = 0; letter < alphabetSize; ++letter) {
+              successor = currentState;
+              this->CBAsuccessorState(successor, this->S.phi[letter]);
+              std::copy(successor.begin(), successor.end(), successors.begin() + (i * alphabetSize + letter) * 2);
+            }
+          }
+        });
+        //Store transitions. Successors which do not already exist form the next level.
+        for (size_t i = 0; i < chunkEnd - chunkBegin; ++i) {
+          for (size_t letter = 0; letter < alphabetSize; ++letter) {
+            auto row = successors.begin() + (i * alphabetSize + letter) * 2;
+            state.assign(row, std::find(row, row + 2, pSize));
+            transitionTable[chunkBegin + i][letter] = states.intern(state, created);
+          }
         }
-        //Store transition
-        targetVector[letter] = stateMap[successorString];
       }
-      //push transition vector to list
-      transitionList.push_back(targetVector);
+      finalStates.insert(finalStates.end(), levelFinal.begin(), levelFinal.end());
+      begin = end;
     }
 
-    //Create state name vector
-    auto stateNames = std::vector<std::string>(stateList.begin(), stateList.end());
-    //Create transition table
-    auto transitionTable = std::vector<std::vector<size_t> >(transitionList.begin(), transitionList.end());
-    //Create final state vector
-    auto finalStates = std::vector<bool>(finalList.begin(), finalList.end());
+    //Merge states with equal behaviour. States on no cycle are treated as not final.
+    auto onCycle = this->statesOnCycles(transitionTable);
+    auto labels = std::vector<size_t>(finalStates.size(), 0);
+    for (size_t q = 0; q < finalStates.size(); ++q) {
+      labels[q] = (onCycle[q] && finalStates[q] ? 1 : 0);
+    }
+    auto representatives = this->minimizeStates(transitionTable, labels, 0);
+    auto minimalNames = std::vector<std::string>(representatives.size());
+    auto minimalFinalStates = std::vector<bool>(representatives.size());
+    for (size_t q = 0; q < representatives.size(); ++q) {
+      minimalNames[q] = stateNames[representatives[q]];
+      minimalFinalStates[q] = (labels[representatives[q]] == 1);
+    }
+    stateNames.swap(minimalNames);
+    finalStates.swap(minimalFinalStates);
+  }
 
-    //return result
+  DeterministicCoBuechiAutomaton AutomatonConverter::convertToCoBuechi() const {
+    auto stateNames = std::vector<std::string>();
+    auto transitionTable = std::vector<std::vector<size_t> >();
+    auto finalStates = std::vector<bool>();
+    this->buildCoBuechi(stateNames, transitionTable, finalStates);
     return DeterministicCoBuechiAutomaton(stateNames, this->S.phi.getAlphabet(), 0, transitionTable, finalStates);
+  }
 
+  void AutomatonConverter::convertToCoBuechi(AutomatonSink& sink) const {
+    auto stateNames = std::vector<std::string>();
+    auto transitionTable = std::vector<std::vector<size_t> >();
+    auto finalStates = std::vector<bool>();
+    this->buildCoBuechi(stateNames, transitionTable, finalStates);
+    this->emitTransitions(sink, "CoBuechi", stateNames, transitionTable);
+    for (size_t q = 0; q < finalStates.size(); ++q) {
+      sink.finalState(q, finalStates[q]);
+    }
+    sink.end();
   }
 
   DeterministicBuechiAutomaton AutomatonConverter::convertToDetBuechi() const {
-    this->S.invertP();
-    auto compAut = this->convertToCoBuechi();
-    this->S.invertP();
+    //A det. Buechi automaton is the dual of a coBuechi automaton for the complement.
+    auto compAut = AutomatonConverter(this->S, !this->complement, this->threads).convertToCoBuechi();
     return compAut.dual();
   }
 
-  DeterministicBuechiAutomaton AutomatonConverter::convertToWeakBuechi() const {
-    //Get element names which are the state names for the automaton
-    auto states = this->S.sPlus.getElementNames();
+  void AutomatonConverter::convertToDetBuechi(AutomatonSink& sink) const {
+    AutomatonConverter(this->S, !this->complement, this->threads).convertToDualBuechi(sink);
+  }
+
+  void AutomatonConverter::convertToDualBuechi(AutomatonSink& sink) const {
+    //Dual of the coBuechi automaton, with inverted final states.
+    auto stateNames = std::vector<std::string>();
+    auto transitionTable = std::vector<std::vector<size_t> >();
+    auto finalStates = std::vector<bool>();
+    this->buildCoBuechi(stateNames, transitionTable, finalStates);
+    this->emitTransitions(sink, "Buechi", stateNames, transitionTable);
+    for (size_t q = 0; q < finalStates.size(); ++q) {
+      sink.finalState(q, !finalStates[q]);
+    }
+    sink.end();
+  }
+
+  void AutomatonConverter::buildWeakBuechi(std::vector<std::string>& stateNames, std::vector<std::vector<size_t> >& transitionTable,
+                                           std::vector<bool>& finalStates) const {
+    //States are the initial state and the elements of sPlus, reached by reading letter images.
+    auto elementNames = this->S.sPlus.getElementNames();
+    size_t size = elementNames.size();
     //Create new initial state
     std::string initialName = "q_0";
     //Change name of initial state if it already occurs in state names
-    while (std::find(states.begin(), states.end(), initialName) != states.end()) {
+    while (std::find(elementNames.begin(), elementNames.end(), initialName) != elementNames.end()) {
       initialName += "0";
     }
-    //Add initial name to state names
-    states.push_back(initialName);
-    //set initial id
-    size_t initial = states.size() - 1;
 
     //Get alphabet
     auto alphabet = this->S.phi.getAlphabet();
 
-    //Build transition table
-    auto transitionTable = std::vector<std::vector<size_t> >(states.size(), std::vector<size_t>(alphabet.size(), 0));
-    for (size_t a = 0; a < alphabet.size(); ++a) {
-      size_t image_a = this->S.phi[a];
-      //anything but initial state
-      for (size_t q = 0; q < states.size() - 1; ++q) {
-        transitionTable[q][a] = this->S.sPlus.product(q, image_a);
+    //Breadth first search from the initial state 0. stateID[s] is the state of element s, or 0 if not reached yet.
+    auto stateID = std::vector<size_t>(size, 0);
+    auto elements = std::vector<size_t>(1, size);
+    auto states = std::vector<std::string>(1, initialName);
+    transitionTable.clear();
+    for (size_t q = 0; q < elements.size(); ++q) {
+      auto row = std::vector<size_t>(alphabet.size(), 0);
+      for (size_t a = 0; a < alphabet.size(); ++a) {
+        size_t image_a = this->S.phi[a];
+        size_t next = (q == 0 ? image_a : this->S.sPlus.product(elements[q], image_a));
+        if (stateID[next] == 0) {
+          stateID[next] = elements.size();
+          elements.push_back(next);
+          states.push_back(elementNames[next]);
+        }
+        row[a] = stateID[next];
       }
-      //initial state
-      transitionTable[initial][a] = image_a;
+      transitionTable.push_back(row);
     }
 
-    //Determine final states
-    auto finalStates = std::vector<bool>(states.size(),false);
-    auto linkedPairs = this->S.sPlus.linkedPairs();
-    for (auto iter = linkedPairs.begin(); iter != linkedPairs.end(); ++iter) {
-      size_t s = iter->first;
-      size_t eOm = this->S.omegaIterationTable[iter->second];
-      //if se^w is in P for a linked pair (s,e), then s is a final state
-      if (this->S.P[this->S.mixedProductTable[s][eOm]]) {
-        finalStates[s] = true;
+    //Determine final states: s is final if se^w is in P for some linked pair (s,e). Only the idempotents
+    //of reached elements are checked.
+    finalStates.assign(states.size(), false);
+    auto const& idempotents = this->S.sPlus.idempotents();
+    for (size_t q = 1; q < states.size(); ++q) {
+      size_t s = elements[q];
+      for (auto iter = idempotents.begin(); iter != idempotents.end(); ++iter) {
+        if (this->S.sPlus.product(s, *iter) == s &&
+            this->accepting(this->S.mixedProduct(s, this->S.omegaIterationTable[*iter]))) {
+          finalStates[q] = true;
+          break;
+        }
       }
     }
 
-    return DeterministicBuechiAutomaton(states, alphabet, initial, transitionTable, finalStates);
+    //Merge states with equal behaviour. States on no cycle are treated as not final.
+    auto onCycle = this->statesOnCycles(transitionTable);
+    auto labels = std::vector<size_t>(finalStates.size(), 0);
+    for (size_t q = 0; q < finalStates.size(); ++q) {
+      labels[q] = (onCycle[q] && finalStates[q] ? 1 : 0);
+    }
+    auto representatives = this->minimizeStates(transitionTable, labels, 0);
+    stateNames.assign(representatives.size(), "");
+    finalStates.assign(representatives.size(), false);
+    for (size_t q = 0; q < representatives.size(); ++q) {
+      stateNames[q] = states[representatives[q]];
+      finalStates[q] = (labels[representatives[q]] == 1);
+    }
   }
 
-  std::string AutomatonConverter::stringValue(std::list<size_t> const& L) const {
-    std::string res = "";
-    for (auto iter = L.begin(); iter != L.end(); ++iter) {
-      res += std::to_string(*iter);
+  DeterministicBuechiAutomaton AutomatonConverter::convertToWeakBuechi() const {
+    auto stateNames = std::vector<std::string>();
+    auto transitionTable = std::vector<std::vector<size_t> >();
+    auto finalStates = std::vector<bool>();
+    this->buildWeakBuechi(stateNames, transitionTable, finalStates);
+    return DeterministicBuechiAutomaton(stateNames, this->S.phi.getAlphabet(), 0, transitionTable, finalStates);
+  }
+
+  void AutomatonConverter::convertToWeakBuechi(AutomatonSink& sink) const {
+    auto stateNames = std::vector<std::string>();
+    auto transitionTable = std::vector<std::vector<size_t> >();
+    auto finalStates = std::vector<bool>();
+    this->buildWeakBuechi(stateNames, transitionTable, finalStates);
+    this->emitTransitions(sink, "Buechi", stateNames, transitionTable);
+    for (size_t q = 0; q < finalStates.size(); ++q) {
+      sink.finalState(q, finalStates[q]);
     }
-    return res;
+    sink.end();
   }
 
-  std::list<size_t> AutomatonConverter::successorState(std::list<size_t> currentState, size_t element) const {
-    //Special case: list is empty.
-    if (currentState.empty()) {
-      std::list<size_t> result = {element};
-      return result;
+  NondeterministicBuechiAutomaton AutomatonConverter::convertToNondeterministicBuechi(bool reduce) const {
+    auto elementNames = this->S.sPlus.getElementNames();
+    size_t size = elementNames.size();
+    auto alphabet = this->S.phi.getAlphabet();
+    //Create new initial state, with a name that does not occur among the element names.
+    std::string initialName = "q_0";
+    while (std::find(elementNames.begin(), elementNames.end(), initialName) != elementNames.end()) {
+      initialName += "0";
     }
-    else {
-      size_t last = currentState.back();
-      size_t prod = this->S.sPlus.product(last, element);
-      //If the new element is not in a strictly higher J class than the last (first 2 conditions) OR
-      //the last element times the new element falls to a deeper J class than the last one's:
-      if (!(this->S.sPlus.j(last, element)) ||
-           (this->S.sPlus.j(element,last))  ||
-          !(this->S.sPlus.r(last, prod))) {
-        //Pop last, recurse with product of last and element as the new rightmost element.
-        currentState.pop_back();
-        return successorState(currentState, prod);
+
+    //States are encoded as follows: s < n is the prefix state with image s, n the initial state, and
+    //n + 1 + e * (n + 1) + x the loop state of idempotent e whose current factor has image x, where x = n
+    //stands for the empty factor. The loop states with empty factor are final.
+    size_t const initialCode = size;
+    auto loopCode = [size](size_t e, size_t x) { return size + 1 + e * (size + 1) + x; };
+    //For each element s, the idempotents e such that (s,e) is an accepting linked pair. Filled when s is reached.
+    auto acceptingLoops = std::vector<std::vector<size_t> >(size);
+    auto loopsKnown = std::vector<bool>(size, false);
+    auto const& idempotents = this->S.sPlus.idempotents();
+
+    //Breadth first search from the initial state.
+    auto stateID = std::unordered_map<size_t, size_t>();
+    auto codes = std::vector<size_t>(1, initialCode);
+    stateID[initialCode] = 0;
+    auto transitionRelation = std::vector<std::vector<std::set<size_t> > >();
+    auto targets = std::vector<size_t>();
+    for (size_t q = 0; q < codes.size(); ++q) {
+      size_t code = codes[q];
+      transitionRelation.push_back(std::vector<std::set<size_t> >(alphabet.size()));
+      for (size_t a = 0; a < alphabet.size(); ++a) {
+        size_t image_a = this->S.phi[a];
+        targets.clear();
+        if (code <= size) {
+          //Prefix: continue, or guess an accepting linked pair (t,e) and start reading factors with image e.
+          size_t t = (code == initialCode ? image_a : this->S.sPlus.product(code, image_a));
+          targets.push_back(t);
+          if (!loopsKnown[t]) {
+            for (auto iter = idempotents.begin(); iter != idempotents.end(); ++iter) {
+              if (this->S.sPlus.product(t, *iter) == t &&
+                  this->accepting(this->S.mixedProduct(t, this->S.omegaIterationTable[*iter]))) {
+                acceptingLoops[t].push_back(*iter);
+              }
+            }
+            loopsKnown[t] = true;
+          }
+          for (auto iter = acceptingLoops[t].begin(); iter != acceptingLoops[t].end(); ++iter) {
+            targets.push_back(loopCode(*iter, size));
+          }
+        }
+        else {
+          //Loop: extend the current factor, and close it if its image is e.
+          size_t e = (code - size - 1) / (size + 1);
+          size_t x = (code - size - 1) % (size + 1);
+          size_t y = (x == size ? image_a : this->S.sPlus.product(x, image_a));
+          targets.push_back(loopCode(e, y));
+          if (y == e) {
+            targets.push_back(loopCode(e, size));
+          }
+        }
+        for (auto iter = targets.begin(); iter != targets.end(); ++iter) {
+          auto found = stateID.find(*iter);
+          if (found == stateID.end()) {
+            found = stateID.insert(std::make_pair(*iter, codes.size())).first;
+            codes.push_back(*iter);
+          }
+          transitionRelation[q][a].insert(found->second);
+        }
+      }
+    }
+    auto finalStates = std::vector<bool>(codes.size(), false);
+    for (size_t q = 0; q < codes.size(); ++q) {
+      finalStates[q] = (codes[q] > size && (codes[q] - size - 1) % (size + 1) == size);
+    }
+
+    //Keep the states from which a final state is reachable, and the initial state.
+    auto predecessors = std::vector<std::vector<size_t> >(codes.size());
+    for (size_t q = 0; q < codes.size(); ++q) {
+      for (auto letterIter = transitionRelation[q].begin(); letterIter != transitionRelation[q].end(); ++letterIter) {
+        for (auto iter = letterIter->begin(); iter != letterIter->end(); ++iter) {
+          predecessors[*iter].push_back(q);
+        }
+      }
+    }
+    auto productive = finalStates;
+    auto Q = std::vector<size_t>();
+    for (size_t q = 0; q < codes.size(); ++q) {
+      if (productive[q]) {
+        Q.push_back(q);
+      }
+    }
+    while (!Q.empty()) {
+      size_t cur = Q.back();
+      Q.pop_back();
+      for (auto iter = predecessors[cur].begin(); iter != predecessors[cur].end(); ++iter) {
+        if (!productive[*iter]) {
+          productive[*iter] = true;
+          Q.push_back(*iter);
+        }
+      }
+    }
+    productive[0] = true;
+    auto newIndex = std::vector<size_t>(codes.size(), 0);
+    auto kept = std::vector<size_t>();
+    for (size_t q = 0; q < codes.size(); ++q) {
+      if (productive[q]) {
+        newIndex[q] = kept.size();
+        kept.push_back(q);
+      }
+    }
+    auto trimmedRelation = std::vector<std::vector<std::set<size_t> > >(kept.size(), std::vector<std::set<size_t> >(alphabet.size()));
+    auto trimmedFinalStates = std::vector<bool>(kept.size(), false);
+    for (size_t q = 0; q < kept.size(); ++q) {
+      trimmedFinalStates[q] = finalStates[kept[q]];
+      for (size_t a = 0; a < alphabet.size(); ++a) {
+        auto const& oldTargets = transitionRelation[kept[q]][a];
+        for (auto iter = oldTargets.begin(); iter != oldTargets.end(); ++iter) {
+          if (productive[*iter]) {
+            trimmedRelation[q][a].insert(newIndex[*iter]);
+          }
+        }
+      }
+    }
+    transitionRelation.swap(trimmedRelation);
+    finalStates.swap(trimmedFinalStates);
+
+    //Optionally reduce by simulation.
+    if (reduce) {
+      auto representatives = this->reduceBySimulation(transitionRelation, finalStates, 0);
+      auto reducedKept = std::vector<size_t>(representatives.size());
+      for (size_t q = 0; q < representatives.size(); ++q) {
+        reducedKept[q] = kept[representatives[q]];
+      }
+      kept.swap(reducedKept);
+    }
+
+    //Name states: prefix states by their image, loop states by idempotent and image of the current factor.
+    auto states = std::vector<std::string>(kept.size());
+    for (size_t q = 0; q < kept.size(); ++q) {
+      size_t code = codes[kept[q]];
+      if (code == initialCode) {
+        states[q] = initialName;
+      }
+      else if (code < size) {
+        states[q] = elementNames[code];
       }
       else {
-        //simply add new element to state.
-        currentState.push_back(element);
-        return currentState;
+        size_t e = (code - size - 1) / (size + 1);
+        size_t x = (code - size - 1) % (size + 1);
+        states[q] = "<" + elementNames[e] + "|" + (x == size ? std::string() : elementNames[x]) + ">";
       }
     }
+    return NondeterministicBuechiAutomaton(states, alphabet, 0, transitionRelation, finalStates);
   }
 
-  size_t AutomatonConverter::calculatePriority(std::list<size_t> const &state) const {
+  void AutomatonConverter::convertToAll(AutomatonSink* weakBuechi, AutomatonSink* coBuechi, AutomatonSink* detBuechi,
+                                        AutomatonSink* parity) const {
+    //Split the threads among the conversions, as they run concurrently.
+    unsigned threads = this->threads;
+    if (threads == 0) {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    unsigned count = 0;
+    for (AutomatonSink* sink : { weakBuechi, coBuechi, detBuechi, parity }) {
+      if (sink != nullptr) {
+        ++count;
+      }
+    }
+    unsigned share = std::max(1u, threads / std::max(1u, count));
+    //The conversions use converters with their share of the threads. The det. Buechi automaton is built by a
+    //converter for the complement. The tables of the strict extension are calculated once, and only if a
+    //conversion other than the weak Buechi one needs them, and copied to the converters.
+    auto converter = AutomatonConverter(this->S, this->complement, share);
+    auto complementConverter = AutomatonConverter(this->S, !this->complement, share);
+    if (coBuechi != nullptr || parity != nullptr) {
+      converter.copyTables(*this);
+    }
+    if (detBuechi != nullptr) {
+      complementConverter.copyTables(*this);
+    }
+    if (parity != nullptr) {
+      this->S.sPlus.calculateJDepths();
+    }
+
+    auto conversions = std::vector<std::function<void()> >();
+    if (weakBuechi != nullptr) {
+      conversions.push_back([&converter, weakBuechi]() { converter.convertToWeakBuechi(*weakBuechi); });
+    }
+    if (coBuechi != nullptr) {
+      conversions.push_back([&converter, coBuechi]() { converter.convertToCoBuechi(*coBuechi); });
+    }
+    if (detBuechi != nullptr) {
+      conversions.push_back([&complementConverter, detBuechi]() { complementConverter.convertToDualBuechi(*detBuechi); });
+    }
+    if (parity != nullptr) {
+      conversions.push_back([&converter, parity]() { converter.convertToParity(*parity); });
+    }
+
+    //Run each conversion in its own thread. The first exception is passed on after all have finished.
+    auto errors = std::vector<std::exception_ptr>(conversions.size());
+    auto workers = std::vector<std::thread>();
+    for (size_t i = 0; i < conversions.size(); ++i) {
+      workers.push_back(std::thread([&conversions, &errors, i]() {
+        try {
+          conversions[i]();
+        }
+        catch (...) {
+          errors[i] = std::current_exception();
+        }
+      }));
+    }
+    for (auto iter = workers.begin(); iter != workers.end(); ++iter) {
+      iter->join();
+    }
+    for (auto iter = errors.begin(); iter != errors.end(); ++iter) {
+      if (*iter) {
+        std::rethrow_exception(*iter);
+      }
+    }
+  }
+
+  void AutomatonConverter::emitTransitions(AutomatonSink& sink, std::string const& type, std::vector<std::string>& stateNames,
+                                           std::vector<std::vector<size_t> >& transitionTable) const {
+    sink.begin(type, stateNames, 0, this->S.phi.getAlphabet());
+    std::vector<std::string>().swap(stateNames);
+    //Release each row once it is passed on.
+    for (size_t q = 0; q < transitionTable.size(); ++q) {
+      sink.transitions(q, transitionTable[q]);
+      std::vector<size_t>().swap(transitionTable[q]);
+    }
+  }
+
+  void AutomatonConverter::successorState(std::vector<size_t>& state, std::vector<size_t>& prefix, size_t element) const {
+    size_t size = this->S.sPlus.size();
+    //Pop the last element as long as the new element does not extend the chain, continuing with the product
+    //of last and element as the new rightmost element.
+    while (!state.empty() && !this->strictExtension[state.back() * size + element]) {
+      element = this->S.sPlus.product(state.back(), element);
+      state.pop_back();
+      prefix.pop_back();
+    }
+    //Add new element to state.
+    prefix.push_back(prefix.empty() ? element : this->S.sPlus.product(prefix.back(), element));
+    state.push_back(element);
+  }
+
+  size_t AutomatonConverter::calculatePriority(std::vector<size_t> const& state, std::vector<size_t> const& prefix) const {
     //basis priority: 2 times j depth of last element.
     size_t last = state.back();
-    size_t depth = this->S.sPlus.jDepth(last);
-    size_t res = 2 * depth;
+    size_t res = 2 * this->S.sPlus.jDepth(last);
     //Get an idempotent in the R class of last. If there is none, add 1 to priority.
-    int e = -1;
-    auto idempotents = this->S.sPlus.idempotents();
-    for (auto iter = idempotents.begin(); iter != idempotents.end(); ++iter) {
-      if (this->S.sPlus.R(last, *iter)) {
-        e = *iter;
-        break;
+    size_t e = this->rIdempotent[last];
+    if (e == this->S.sPlus.size()) {
+      return res + 1;
+    }
+    //Case distinction: states with only one element.
+    if (state.size() == 1) {
+      //Add 1 if e^w is not in P.
+      return res + (this->accepting(this->S.omegaIterationTable[e]) ? 0 : 1);
+    }
+    //Add 1 if se^w not in P, for the product s of all but the last element.
+    size_t s = prefix[state.size() - 2];
+    return res + (this->accepting(this->S.mixedProduct(s, this->S.omegaIterationTable[e])) ? 0 : 1);
+  }
+
+  void AutomatonConverter::minimizePriorities(std::vector<std::vector<size_t> > const& transitionTable,
+                                              std::vector<size_t>& priorities) const {
+    size_t size = priorities.size();
+    auto states = std::vector<size_t>(size, 0);
+    for (size_t q = 0; q < size; ++q) {
+      states[q] = q;
+    }
+    auto newPriorities = std::vector<size_t>(size, 0);
+    auto assigned = std::vector<bool>(size, false);
+    this->minimizePriorities(states, transitionTable, priorities, newPriorities, assigned);
+    //States on no cycle get the least priority used, which does not influence acceptance.
+    size_t least = 0;
+    bool found = false;
+    for (size_t q = 0; q < size; ++q) {
+      if (assigned[q] && (!found || newPriorities[q] < least)) {
+        least = newPriorities[q];
+        found = true;
       }
     }
-    if (e == -1) {
-      return res + 1;
+    for (size_t q = 0; q < size; ++q) {
+      priorities[q] = (assigned[q] ? newPriorities[q] : least);
     }
-    else {
-      //Case distinction: states with only one element.
-      if (state.size() == 1) {
-        //Add 1 if e^w is not in P.
-        return res + (this->S.P[this->S.omegaIterationTable[e]] ? 0 : 1);
+  }
+
+  size_t AutomatonConverter::minimizePriorities(std::vector<size_t> const& states, std::vector<std::vector<size_t> > const& transitionTable,
+                                                std::vector<size_t> const& priorities, std::vector<size_t>& newPriorities,
+                                                std::vector<bool>& assigned) const {
+    //Subgraph induced by states, with local indices.
+    auto localIndex = std::unordered_map<size_t, size_t>();
+    for (size_t i = 0; i < states.size(); ++i) {
+      localIndex[states[i]] = i;
+    }
+    auto graph = std::vector<std::vector<size_t> >(states.size());
+    auto selfLoop = std::vector<bool>(states.size(), false);
+    for (size_t i = 0; i < states.size(); ++i) {
+      for (auto iter = transitionTable[states[i]].begin(); iter != transitionTable[states[i]].end(); ++iter) {
+        auto target = localIndex.find(*iter);
+        if (target != localIndex.end()) {
+          graph[i].push_back(target->second);
+          if (target->second == i) {
+            selfLoop[i] = true;
+          }
+        }
       }
-      else {
-        //Calculate the front s.
-        size_t s = state.front();
-        for (auto iter = ++state.begin(); *iter != last; ++iter) {
-          s = this->S.sPlus.product(s, *iter);
+    }
+    auto component = stronglyConnectedComponents(graph);
+    size_t components = 0;
+    for (size_t i = 0; i < states.size(); ++i) {
+      components = std::max(components, component[i] + 1);
+    }
+    auto members = std::vector<std::vector<size_t> >(components);
+    for (size_t i = 0; i < states.size(); ++i) {
+      members[component[i]].push_back(states[i]);
+    }
+
+    size_t result = 0;
+    for (size_t c = 0; c < components; ++c) {
+      auto const& C = members[c];
+      //Skip components without a cycle.
+      if (C.size() == 1 && !selfLoop[localIndex[C.front()]]) {
+        continue;
+      }
+      size_t maxPriority = 0;
+      for (auto iter = C.begin(); iter != C.end(); ++iter) {
+        maxPriority = std::max(maxPriority, priorities[*iter]);
+      }
+      //Solve the rest of the component first.
+      auto rest = std::vector<size_t>();
+      for (auto iter = C.begin(); iter != C.end(); ++iter) {
+        if (priorities[*iter] != maxPriority) {
+          rest.push_back(*iter);
         }
-        //Calculate se^w.
-        size_t seOm = this->S.mixedProductTable[s][this->S.omegaIterationTable[e]];
-        //Add 1 if se^w not in P.
-        return res + (this->S.P[seOm] ? 0 : 1);
       }
+      size_t restBound = this->minimizePriorities(rest, transitionTable, priorities, newPriorities, assigned);
+      //Least priority of the same parity as maxPriority, at least as large as all priorities in the rest.
+      size_t priority = maxPriority % 2;
+      if (restBound > 0) {
+        priority = restBound - 1;
+        if (priority % 2 != maxPriority % 2) {
+          ++priority;
+        }
+      }
+      for (auto iter = C.begin(); iter != C.end(); ++iter) {
+        if (priorities[*iter] == maxPriority) {
+          newPriorities[*iter] = priority;
+          assigned[*iter] = true;
+        }
+      }
+      result = std::max(result, priority + 1);
     }
+    return result;
+  }
 
+  std::vector<bool> AutomatonConverter::statesOnCycles(std::vector<std::vector<size_t> > const& transitionTable) const {
+    size_t size = transitionTable.size();
+    auto component = stronglyConnectedComponents(transitionTable);
+    auto componentSize = std::vector<size_t>(size, 0);
+    for (size_t q = 0; q < size; ++q) {
+      ++componentSize[component[q]];
+    }
+    auto result = std::vector<bool>(size, false);
+    for (size_t q = 0; q < size; ++q) {
+      if (componentSize[component[q]] > 1) {
+        result[q] = true;
+      }
+      for (auto iter = transitionTable[q].begin(); iter != transitionTable[q].end(); ++iter) {
+        if (*iter == q) {
+          result[q] = true;
+        }
+      }
+    }
+    return result;
+  }
+
+  std::vector<bool> AutomatonConverter::directSimulation(std::vector<std::vector<std::set<size_t> > > const& transitionRelation,
+                                                         std::vector<bool> const& finalStates) const {
+    size_t size = transitionRelation.size();
+    auto simulates = std::vector<bool>(size * size, false);
+    for (size_t p = 0; p < size; ++p) {
+      for (size_t q = 0; q < size; ++q) {
+        simulates[p * size + q] = (!finalStates[p] || finalStates[q]);
+      }
+    }
+    //Remove pairs where a transition of p can not be matched by q, until nothing changes.
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (size_t p = 0; p < size; ++p) {
+        for (size_t q = 0; q < size; ++q) {
+          if (!simulates[p * size + q] || p == q) {
+            continue;
+          }
+          bool matched = true;
+          for (size_t a = 0; a < transitionRelation[p].size() && matched; ++a) {
+            auto const& pTargets = transitionRelation[p][a];
+            auto const& qTargets = transitionRelation[q][a];
+            for (auto pIter = pTargets.begin(); pIter != pTargets.end() && matched; ++pIter) {
+              matched = false;
+              for (auto qIter = qTargets.begin(); qIter != qTargets.end() && !matched; ++qIter) {
+                matched = simulates[*pIter * size + *qIter];
+              }
+            }
+          }
+          if (!matched) {
+            simulates[p * size + q] = false;
+            changed = true;
+          }
+        }
+      }
+    }
+    return simulates;
   }
 
-  std::string AutomatonConverter::stateName(std::list<size_t> const &state) const {
+  std::vector<size_t> AutomatonConverter::reduceBySimulation(std::vector<std::vector<std::set<size_t> > >& transitionRelation,
+                                                             std::vector<bool>& finalStates, size_t initial) const {
+    size_t size = transitionRelation.size();
+    auto simulates = this->directSimulation(transitionRelation, finalStates);
+    //Each state is represented by the least simulation equivalent state.
+    auto classOf = std::vector<size_t>(size, 0);
+    for (size_t p = 0; p < size; ++p) {
+      classOf[p] = p;
+      for (size_t q = 0; q < p; ++q) {
+        if (simulates[p * size + q] && simulates[q * size + p]) {
+          classOf[p] = classOf[q];
+          break;
+        }
+      }
+    }
+    //Breadth first search over the representatives, dropping transitions to strictly simulated targets.
+    size_t const undefined = std::numeric_limits<size_t>::max();
+    auto newIndex = std::vector<size_t>(size, undefined);
+    auto representatives = std::vector<size_t>(1, classOf[initial]);
+    newIndex[classOf[initial]] = 0;
+    auto reducedRelation = std::vector<std::vector<std::set<size_t> > >();
+    for (size_t q = 0; q < representatives.size(); ++q) {
+      size_t p = representatives[q];
+      reducedRelation.push_back(std::vector<std::set<size_t> >(transitionRelation[p].size()));
+      for (size_t a = 0; a < transitionRelation[p].size(); ++a) {
+        auto const& targets = transitionRelation[p][a];
+        for (auto iter = targets.begin(); iter != targets.end(); ++iter) {
+          bool dominated = false;
+          for (auto other = targets.begin(); other != targets.end() && !dominated; ++other) {
+            dominated = (simulates[*iter * size + *other] && !simulates[*other * size + *iter]);
+          }
+          if (dominated) {
+            continue;
+          }
+          size_t target = classOf[*iter];
+          if (newIndex[target] == undefined) {
+            newIndex[target] = representatives.size();
+            representatives.push_back(target);
+          }
+          reducedRelation[q][a].insert(newIndex[target]);
+        }
+      }
+    }
+    auto reducedFinalStates = std::vector<bool>(representatives.size(), false);
+    for (size_t q = 0; q < representatives.size(); ++q) {
+      reducedFinalStates[q] = finalStates[representatives[q]];
+    }
+    transitionRelation.swap(reducedRelation);
+    finalStates.swap(reducedFinalStates);
+    return representatives;
+  }
+
+  std::vector<size_t> AutomatonConverter::minimizeStates(std::vector<std::vector<size_t> >& transitionTable,
+                                                         std::vector<size_t> const& labels, size_t initial) const {
+    size_t size = transitionTable.size();
+    size_t alphabetSize = this->S.phi.size();
+    auto blocks = refinePartition(size, alphabetSize, [&transitionTable](size_t letter, size_t state, size_t& target) {
+      target = transitionTable[state][letter];
+      return true;
+    }, labels);
+
+    //Number the reachable blocks in breadth first order, with one representative state each.
+    auto number = std::vector<size_t>(size, size);
+    auto representatives = std::vector<size_t>(1, initial);
+    number[blocks[initial]] = 0;
+    auto minimalTable = std::vector<std::vector<size_t> >();
+    for (size_t current = 0; current < representatives.size(); ++current) {
+      auto targetVector = std::vector<size_t>(alphabetSize, 0);
+      for (size_t letter = 0; letter < alphabetSize; ++letter) {
+        size_t target = transitionTable[representatives[current]][letter];
+        if (number[blocks[target]] == size) {
+          number[blocks[target]] = representatives.size();
+          representatives.push_back(target);
+        }
+        targetVector[letter] = number[blocks[target]];
+      }
+      minimalTable.push_back(targetVector);
+    }
+    transitionTable.swap(minimalTable);
+    return representatives;
+  }
+
+  std::string AutomatonConverter::stateName(std::vector<size_t> const& state) const {
     std::string res = "<";
     for (auto iter = state.begin(); iter != state.end(); ++iter) {
       res += this->S.sPlus.elementName(*iter);
@@ -269,47 +993,42 @@ namespace omalg {
     return res;
   }
 
-  std::list<size_t> AutomatonConverter::CBAsuccessorState(std::list<size_t> const& currentState, size_t element) const {
-    if (currentState.size() == 0) {
+  void AutomatonConverter::CBAsuccessorState(std::vector<size_t>& state, size_t element) const {
+    if (state.size() == 0) {
       //initial state
-      std::list<size_t> result = {element};
-      return result;
+      state.push_back(element);
     }
-    else if (currentState.size() == 1){
+    else if (state.size() == 1){
       //single element states
-      size_t s = currentState.front();
+      size_t s = state.front();
       size_t se = this->S.sPlus.product(s, element);
       //Check s <_j element, s J s*element and s not sub loop accepting, (s, element) sub loop accepting
-      if (this->S.sPlus.j(s, element) && !(this->S.sPlus.j(element, s)) && this->S.sPlus.r(s,se) &&
+      if (this->strictExtension[s * this->S.sPlus.size() + element] &&
           !(this->subLoopAccepting(s)) && this->subLoopAccepting(s, element)) {
-        std::list<size_t> result = {s, element};
-        return result;
+        state.push_back(element);
       }
       else {
-        std::list<size_t> result = {se};
-        return result;
+        state.front() = se;
       }
     }
     else {
     //double element states
-      size_t s = currentState.front();
-      size_t t = currentState.back();
+      size_t s = state.front();
+      size_t t = state.back();
       size_t te = this->S.sPlus.product(t, element);
       size_t ste = this->S.sPlus.product(s, te);
       //Check s <_j t*element, s J s*t*element and (s, t*element) sub loop accepting
-      if (this->S.sPlus.j(s, te) && !(this->S.sPlus.j(te, s)) && this->S.sPlus.r(s, ste) &&
-          this->subLoopAccepting(s, te)) {
-        std::list<size_t> result = {s, te};
-        return result;
+      if (this->strictExtension[s * this->S.sPlus.size() + te] && this->subLoopAccepting(s, te)) {
+        state.back() = te;
       }
       else {
-        std::list<size_t> result = {ste};
-        return result;
+        state.pop_back();
+        state.front() = ste;
       }
     }
   }
 
-  bool AutomatonConverter::decideFinality(std::list<size_t> const &state) const {
+  bool AutomatonConverter::decideFinality(std::vector<size_t> const& state) const {
     //states of Q2 are always final
     if (state.size() == 2) {
       return true;
@@ -320,59 +1039,36 @@ namespace omalg {
   }
 
   bool AutomatonConverter::subLoopAccepting(size_t t) const {
-    auto idem = this->S.sPlus.idempotents();
-    //Check idempotents in the same R class for acceptance.
-    for (auto iter = idem.begin(); iter != idem.end(); ++iter) {
-      if (this->S.sPlus.R(t, *iter)) {
-        return this->S.P[this->S.omegaIterationTable[*iter]];
-      }
-    }
-    //R class is irregular -> check above linked pairs.
-    auto pairs = this->S.sPlus.linkedPairs();
-    for (auto iter = pairs.begin(); iter != pairs.end(); ++iter) {
-      size_t r = iter->first;
-      size_t e = iter->second;
-      size_t tr = this->S.sPlus.product(t, r);
-      //Check if t <_j r and tr J t.
-      if (this->S.sPlus.j(t, r) && !(this->S.sPlus.j(r, t)) && this->S.sPlus.r(t, tr)) {
-        //Check if tre^w in P for sub loop acceptance.
-        size_t eOm = this->S.omegaIterationTable[e];
-        if(!(this->S.P[this->S.mixedProductTable[tr][eOm]])) {
-          return false;
-        }
-      }
-    }
-    //All above linked pairs are accepting.
-    return true;
+    return this->subLoopTable[t];
   }
 
   bool AutomatonConverter::subLoopAccepting(size_t s, size_t t) const {
-    auto idem = this->S.sPlus.idempotents();
-    //Check idempotents in the same R class for acceptance.
-    for (auto iter = idem.begin(); iter != idem.end(); ++iter) {
-      if (this->S.sPlus.R(t, *iter)) {
-        size_t eOm = this->S.omegaIterationTable[*iter];
-        return this->S.P[this->S.mixedProductTable[s][eOm]];
-      }
-    }
-    //R class is irregular -> check above linked pairs.
-    auto pairs = this->S.sPlus.linkedPairs();
-    for (auto iter = pairs.begin(); iter != pairs.end(); ++iter) {
-      size_t r = iter->first;
-      size_t e = iter->second;
-      size_t tr = this->S.sPlus.product(t, r);
-      size_t str = this->S.sPlus.product(s, tr);
-      //Check if t <_j r and tr J t.
-      if (this->S.sPlus.j(t, r) && !(this->S.sPlus.j(r, t)) && this->S.sPlus.r(t, tr)) {
-        //Check if stre^w in P for sub loop acceptance.
-        size_t eOm = this->S.omegaIterationTable[e];
-        if(!(this->S.P[this->S.mixedProductTable[str][eOm]])) {
-          return false;
+    size_t size = this->S.sPlus.size();
+    size_t position = s * size + t;
+    uint64_t word = this->subLoopPairs[position / 32].load(std::memory_order_relaxed);
+    size_t bit = 2 * (position % 32);
+    if ((word >> bit) & 1) {
+      return (word >> (bit + 1)) & 1;
+    }
+    bool result = true;
+    size_t e = this->rIdempotent[t];
+    if (e != size) {
+      //Regular R class: decided by se^w for its idempotent e.
+      result = this->accepting(this->S.mixedProduct(s, this->S.omegaIterationTable[e]));
+    }
+    else {
+      //R class is irregular -> check above linked pairs (r, f), i.e. t <_j r and tr J t, for stf^w in P.
+      auto const& pairs = this->S.sPlus.linkedPairs();
+      for (auto iter = pairs.begin(); iter != pairs.end() && result; ++iter) {
+        size_t r = iter->first;
+        if (this->strictExtension[t * size + r]) {
+          size_t str = this->S.sPlus.product(s, this->S.sPlus.product(t, r));
+          result = this->accepting(this->S.mixedProduct(str, this->S.omegaIterationTable[iter->second]));
         }
       }
     }
-    //All above linked pairs are accepting.
-    return true;
+    this->subLoopPairs[position / 32].fetch_or((uint64_t(1) | (uint64_t(result ? 1 : 0) << 1)) << bit, std::memory_order_relaxed);
+    return result;
   }
 
 }
\ No newline at end of file
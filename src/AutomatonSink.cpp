@@ -0,0 +1,116 @@
+#include "AutomatonSink.h"
+#include "IOHandlerExceptions.h"
+
+namespace omalg {
+
+  StreamAutomatonSink::StreamAutomatonSink(std::ostream& theOut)
+    : out(theOut), transitionsStarted(false), acceptanceStarted(false), acceptanceEntries(0) { }
+
+  void StreamAutomatonSink::begin(std::string const& type, std::vector<std::string> const& theStateNames, size_t initialState,
+                                  std::vector<std::string> const& theAlphabet) {
+    this->stateNames = theStateNames;
+    this->alphabet = theAlphabet;
+    this->transitionsStarted = false;
+    this->acceptanceStarted = false;
+    this->acceptanceEntries = 0;
+    this->out << type << ";\n" << "Deterministic;\n";
+    //State names, initial state and alphabet
+    for (auto iter = this->stateNames.begin(); iter != this->stateNames.end(); ++iter) {
+      if (iter != this->stateNames.begin()) {
+        this->out << ",";
+      }
+      this->out << *iter;
+    }
+    this->out << ";\n" << this->stateNames[initialState] << ";\n";
+    for (auto iter = this->alphabet.begin(); iter != this->alphabet.end(); ++iter) {
+      if (iter != this->alphabet.begin()) {
+        this->out << ",";
+      }
+      this->out << *iter;
+    }
+    this->out << ";\n";
+  }
+
+  void StreamAutomatonSink::transitions(size_t state, std::vector<size_t> const& targets) {
+    //Add newline after each origin state
+    if (this->transitionsStarted) {
+      this->out << ",\n";
+    }
+    this->transitionsStarted = true;
+    std::string const& origin = this->stateNames[state];
+    for (size_t letter = 0; letter < targets.size(); ++letter) {
+      if (letter > 0) {
+        this->out << ",";
+      }
+      this->out << "(" << origin << "," << this->alphabet[letter] << "," << this->stateNames[targets[letter]] << ")";
+    }
+  }
+
+  void StreamAutomatonSink::startAcceptanceEntry() {
+    if (!this->acceptanceStarted) {
+      this->out << "\n";
+      this->acceptanceStarted = true;
+    }
+    if (this->acceptanceEntries > 0) {
+      this->out << ",";
+    }
+    ++this->acceptanceEntries;
+  }
+
+  void StreamAutomatonSink::priority(size_t, size_t priority) {
+    this->startAcceptanceEntry();
+    this->out << priority;
+  }
+
+  void StreamAutomatonSink::finalState(size_t state, bool isFinal) {
+    //Only final states are listed.
+    if (isFinal) {
+      this->startAcceptanceEntry();
+      this->out << this->stateNames[state];
+    }
+  }
+
+  void StreamAutomatonSink::end() {
+    if (!this->acceptanceStarted) {
+      this->out << "\n";
+    }
+    this->out << ";";
+    this->out.flush();
+    if (this->out.fail()) {
+      throw WriteFailedException();
+    }
+  }
+
+  FileAutomatonSink::FileAutomatonSink(std::string const& theFileName)
+    : fileName(theFileName), sink(out) { }
+
+  void FileAutomatonSink::begin(std::string const& type, std::vector<std::string> const& stateNames, size_t initialState,
+                                std::vector<std::string> const& alphabet) {
+    this->out.open(this->fileName, std::ios::out);
+    if (!this->out.good()) {
+      throw OpenFailedException(this->fileName);
+    }
+    this->sink.begin(type, stateNames, initialState, alphabet);
+  }
+
+  void FileAutomatonSink::transitions(size_t state, std::vector<size_t> const& targets) {
+    this->sink.transitions(state, targets);
+  }
+
+  void FileAutomatonSink::priority(size_t state, size_t priority) {
+    this->sink.priority(state, priority);
+  }
+
+  void FileAutomatonSink::finalState(size_t state, bool isFinal) {
+    this->sink.finalState(state, isFinal);
+  }
+
+  void FileAutomatonSink::end() {
+    this->sink.end();
+    this->out.close();
+    if (this->out.fail()) {
+      throw CloseFailedException(this->fileName);
+    }
+  }
+
+}
@@ -327,7 +327,7 @@ namespace omalg {
     return A;
   }
 
-  OmegaSemigroup* IOHandler::readOmegaSemigroupFromStream(std::istream &in) {
+  OmegaSemigroup* IOHandler::readOmegaSemigroupFromStream(std::istream &in, bool validate) {
     std::vector<std::string> lines;
     std::string temp;
     const size_t minLines = 8;
@@ -509,10 +509,19 @@ namespace omalg {
 
     //create omega semigroup
     OmegaSemigroup* S = new OmegaSemigroup(sPlus, omegaNames, mixedTable, omegaTable, P, phi);
+
+    //check axioms
+    if (validate) {
+      std::string violation = S->axiomViolation();
+      if (!violation.empty()) {
+        delete S;
+        throw AxiomViolationException(violation);
+      }
+    }
     return S;
   }
 
-  OmegaSemigroup* IOHandler::readOmegaSemigroupFromFile(std::string inputFileName) {
+  OmegaSemigroup* IOHandler::readOmegaSemigroupFromFile(std::string inputFileName, bool validate) {
     std::ifstream in;
     in.open(inputFileName, std::ios::in);
     if (!in.good()) {
@@ -521,7 +530,7 @@ namespace omalg {
     //Read omega semigroup from file.
     OmegaSemigroup* result;
     try {
-      result = this->readOmegaSemigroupFromStream(in);
+      result = this->readOmegaSemigroupFromStream(in, validate);
     }
     catch(IOException const &ex) {
       //An exception was thrown while reading from file.
@@ -537,9 +546,9 @@ namespace omalg {
     return result;
   }
 
-  OmegaSemigroup* IOHandler::readOmegaSemigroupFromStdin() {
+  OmegaSemigroup* IOHandler::readOmegaSemigroupFromStdin(bool validate) {
     OmegaSemigroup* S;
-    S = this->readOmegaSemigroupFromStream(std::cin);
+    S = this->readOmegaSemigroupFromStream(std::cin, validate);
     return S;
   }
 
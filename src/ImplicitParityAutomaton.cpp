@@ -0,0 +1,60 @@
+#include <algorithm>
+
+#include "ImplicitParityAutomaton.h"
+
+namespace omalg {
+
+  ImplicitParityAutomaton::ImplicitParityAutomaton(OmegaSemigroup const& theS)
+    : S(theS), converter(theS), width(1) {
+    this->converter.calculateTables();
+    this->S.sPlus.calculateJDepths();
+    //Chains are strictly decreasing in the J order, so their length is bounded by the maximal J depth + 1.
+    size_t size = this->S.sPlus.size();
+    for (size_t s = 0; s < size; ++s) {
+      this->width = std::max(this->width, this->S.sPlus.jDepth(s) + 1);
+    }
+  }
+
+  ImplicitParityAutomaton::State ImplicitParityAutomaton::initial() const {
+    return State();
+  }
+
+  ImplicitParityAutomaton::State ImplicitParityAutomaton::successor(State const& state, size_t letter) const {
+    auto result = state;
+    auto prefix = this->prefixProducts(state);
+    this->converter.successorState(result, prefix, this->S.phi[letter]);
+    return result;
+  }
+
+  size_t ImplicitParityAutomaton::priority(State const& state) const {
+    if (state.empty()) {
+      return 0;
+    }
+    return this->converter.calculatePriority(state, this->prefixProducts(state));
+  }
+
+  std::string ImplicitParityAutomaton::stateName(State const& state) const {
+    if (state.empty()) {
+      return "<>";
+    }
+    return this->converter.stateName(state);
+  }
+
+  std::vector<std::string> ImplicitParityAutomaton::getAlphabet() const {
+    return this->S.phi.getAlphabet();
+  }
+
+  size_t ImplicitParityAutomaton::alphabetSize() const {
+    return this->S.phi.size();
+  }
+
+  std::vector<size_t> ImplicitParityAutomaton::prefixProducts(State const& state) const {
+    auto prefix = std::vector<size_t>();
+    prefix.reserve(this->width);
+    for (auto iter = state.begin(); iter != state.end(); ++iter) {
+      prefix.push_back(prefix.empty() ? *iter : this->S.sPlus.product(prefix.back(), *iter));
+    }
+    return prefix;
+  }
+
+}
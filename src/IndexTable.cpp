@@ -0,0 +1,88 @@
+#include <limits>
+#include <stdexcept>
+
+#include "IndexTable.h"
+#include "GeneralException.h"
+
+namespace omalg {
+
+  IndexTable::IndexTable()
+    : rows(0), columns(0), width(1) { }
+
+  IndexTable::IndexTable(size_t theRows, size_t theColumns, size_t bound)
+    : rows(theRows), columns(theColumns), width(1) {
+    this->allocate(bound);
+  }
+
+  IndexTable::IndexTable(std::vector<std::vector<size_t> > const& table, size_t bound)
+    : rows(table.size()), columns(table.empty() ? 0 : table.front().size()), width(1) {
+    this->allocate(bound);
+    for (size_t row = 0; row < this->rows; ++row) {
+      for (size_t column = 0; column < this->columns; ++column) {
+        this->set(row, column, table[row][column]);
+      }
+    }
+  }
+
+  IndexTable::IndexTable(std::vector<size_t> const& values, size_t bound)
+    : rows(1), columns(values.size()), width(1) {
+    this->allocate(bound);
+    for (size_t column = 0; column < this->columns; ++column) {
+      this->set(0, column, values[column]);
+    }
+  }
+
+  void IndexTable::allocate(size_t bound) {
+    //Choose the smallest width that can hold all indices below bound.
+    size_t entries = this->rows * this->columns;
+    if (bound <= size_t(std::numeric_limits<uint8_t>::max()) + 1) {
+      this->width = 1;
+      this->narrowEntries.assign(entries, 0);
+    }
+    else if (bound <= size_t(std::numeric_limits<uint16_t>::max()) + 1) {
+      this->width = 2;
+      this->mediumEntries.assign(entries, 0);
+    }
+    else if (bound <= size_t(std::numeric_limits<uint32_t>::max()) + 1) {
+      this->width = 4;
+      this->wideEntries.assign(entries, 0);
+    }
+    else {
+      throw TableTooLargeException();
+    }
+  }
+
+  size_t IndexTable::at(size_t position) const {
+    if (position >= this->rows * this->columns) {
+      throw std::out_of_range("IndexTable::at");
+    }
+    return (*this)[position];
+  }
+
+  void IndexTable::set(size_t row, size_t column, size_t value) {
+    size_t position = row * this->columns + column;
+    switch (this->width) {
+    case 1:
+      this->narrowEntries[position] = static_cast<uint8_t>(value);
+      break;
+    case 2:
+      this->mediumEntries[position] = static_cast<uint16_t>(value);
+      break;
+    default:
+      this->wideEntries[position] = static_cast<uint32_t>(value);
+    }
+  }
+
+  size_t IndexTable::rowCount() const {
+    return this->rows;
+  }
+
+  size_t IndexTable::columnCount() const {
+    return this->columns;
+  }
+
+  size_t IndexTable::bytesPerEntry() const {
+    return this->width;
+  }
+
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <exception>
 
 #include "Morphism.h"
@@ -5,14 +6,15 @@
 namespace omalg {
 
   Morphism::Morphism(std::vector<size_t> theValues, std::vector<std::string> theAlphabet)
-    : values(theValues), alphabet(theAlphabet) {}
+    : values(theValues, theValues.empty() ? 0 : *std::max_element(theValues.begin(), theValues.end()) + 1),
+      alphabet(theAlphabet) {}
 
   std::vector<std::string> Morphism::getAlphabet() const {
     return this->alphabet;
   }
   
   size_t Morphism::size() const {
-    return this->values.size();
+    return this->values.columnCount();
   }
 
   size_t Morphism::apply(size_t letter) const {
@@ -1,105 +1,400 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <list>
+#include <queue>
+#include <unordered_map>
 
 #include "OmegaSemigroup.h"
 #include "DeterministicBuechiAutomaton.h"
 #include "DeterministicCoBuechiAutomaton.h"
 #include "DeterministicParityAutomaton.h"
 #include "AutomatonConverter.h"
+#include "ParallelFor.h"
+#include "PartitionRefinement.h"
+#include "StronglyConnectedComponents.h"
 
 namespace omalg {
+
+  namespace {
+
+    /**
+     * Hash for signature rows.
+     */
+    template <typename T>
+    struct SignatureHash {
+      size_t operator()(std::vector<T> const& signature) const {
+        size_t hash = signature.size();
+        for (auto iter = signature.begin(); iter != signature.end(); ++iter) {
+          hash ^= std::hash<T>()(*iter) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        }
+        return hash;
+      }
+    };
+
+    /**
+     * Numbers the rows of a signature table by order of first occurrence of each distinct row.
+     */
+    template <typename T>
+    std::vector<size_t> groupSignatures(std::vector<std::vector<T> > const& signatures) {
+      auto groups = std::unordered_map<std::vector<T>, size_t, SignatureHash<T> >();
+      auto result = std::vector<size_t>(signatures.size(), 0);
+      for (size_t row = 0; row < signatures.size(); ++row) {
+        auto inserted = groups.insert(std::make_pair(signatures[row], groups.size()));
+        result[row] = inserted.first->second;
+      }
+      return result;
+    }
+
+  }
   OmegaSemigroup::OmegaSemigroup(Semigroup theSemigroup, std::vector<std::string> theOmegaElementNames,
       std::vector<std::vector<size_t> > theMixedProductTable, std::vector<size_t> theOmegaIterationTable,
       std::vector<bool> theP, Morphism thePhi)
         : sPlus(theSemigroup), omegaElementNames(theOmegaElementNames),
-          mixedProductTable(theMixedProductTable), omegaIterationTable(theOmegaIterationTable),
+          mixedProductTable(theMixedProductTable, theOmegaElementNames.size()),
+          omegaIterationTable(theOmegaIterationTable, theOmegaElementNames.size()),
           P(theP), phi(thePhi) { }
 
-  inline size_t OmegaSemigroup::product(size_t lhs, size_t rhs) const {
-    return this->sPlus.product(lhs, rhs);
+  OmegaSemigroup::DerivedColumns::DerivedColumns(std::vector<std::pair<size_t, size_t> > const& theRepresentatives)
+    : representatives(theRepresentatives), flags(new std::once_flag[theRepresentatives.size()]),
+      columns(theRepresentatives.size()) { }
+
+  OmegaSemigroup::OmegaSemigroup(Semigroup theSemigroup, std::vector<std::string> theOmegaElementNames,
+      std::vector<std::vector<size_t> > theMixedProductTable, std::vector<std::pair<size_t, size_t> > theRepresentatives,
+      std::vector<size_t> theOmegaIterationTable, std::vector<bool> theP, Morphism thePhi)
+        : sPlus(theSemigroup), omegaElementNames(theOmegaElementNames),
+          mixedProductTable(theMixedProductTable, theOmegaElementNames.size()),
+          omegaIterationTable(theOmegaIterationTable, theOmegaElementNames.size()),
+          P(theP), phi(thePhi) {
+    if (!theRepresentatives.empty()) {
+      this->derived.reset(new DerivedColumns(theRepresentatives));
+    }
   }
 
-  inline size_t OmegaSemigroup::mixedProduct(size_t plusElement, size_t omegaElement) const {
-    return this->mixedProductTable[plusElement][omegaElement];
+  OmegaSemigroup::OmegaSemigroup(OmegaSemigroup const& S)
+    : sPlus(S.sPlus), omegaElementNames(S.omegaElementNames), mixedProductTable(S.mixedProductTable),
+      omegaIterationTable(S.omegaIterationTable), P(S.P), phi(S.phi) {
+    if (S.derived) {
+      this->derived.reset(new DerivedColumns(S.derived->representatives));
+    }
+  }
+
+  OmegaSemigroup& OmegaSemigroup::operator=(OmegaSemigroup const& S) {
+    if (&S != this) {
+      this->sPlus = S.sPlus;
+      this->omegaElementNames = S.omegaElementNames;
+      this->mixedProductTable = S.mixedProductTable;
+      this->omegaIterationTable = S.omegaIterationTable;
+      this->P = S.P;
+      this->phi = S.phi;
+      this->derived.reset(S.derived ? new DerivedColumns(S.derived->representatives) : nullptr);
+    }
+    return *this;
+  }
+
+  IndexTable const& OmegaSemigroup::derivedColumn(size_t omegaElement) const {
+    size_t position = omegaElement - this->mixedProductTable.columnCount();
+    DerivedColumns& columns = *this->derived;
+    std::call_once(columns.flags[position], [&]() {
+      //t * (s * y) = (ts) * y, where y has a column in the table.
+      size_t s = columns.representatives[position].first;
+      size_t y = columns.representatives[position].second;
+      auto column = IndexTable(1, this->sPlus.size(), this->omegaElementNames.size());
+      for (size_t t = 0; t < this->sPlus.size(); ++t) {
+        column.set(0, t, this->mixedProductTable(this->sPlus.product(t, s), y));
+      }
+      columns.columns[position] = column;
+    });
+    return columns.columns[position];
+  }
+
+  inline size_t OmegaSemigroup::product(size_t lhs, size_t rhs) const {
+    return this->sPlus.product(lhs, rhs);
   }
 
   inline size_t OmegaSemigroup::omegaIteration(size_t element) const {
     return this->omegaIterationTable[element];
   }
 
-  void OmegaSemigroup::invertP() {
-    for (auto iter = this->P.begin(); iter != this->P.end(); ++iter) {
-      *iter = !*iter;
-    }
+  bool OmegaSemigroup::accepting(size_t omegaElement, bool complement) const {
+    return this->P[omegaElement] != complement;
   }
 
-  //TODO Find a more efficient implementation
-  void OmegaSemigroup::reduceToSyntactic() {
-    //Reduce sPlus
+  void OmegaSemigroup::reduceToGenerated() {
     size_t pSize = this->sPlus.size();
-    //list of all element ids yet to check
-    auto toCheck = std::list<size_t>();
+    size_t oSize = this->omegaElementNames.size();
+    auto Q = std::queue<size_t>();
+
+    //Generated finite elements: closure of the letter images under right multiplication with letter images.
+    auto pReachable = std::vector<bool>(pSize, false);
+    for (size_t letter = 0; letter < this->phi.size(); ++letter) {
+      if (!pReachable[this->phi[letter]]) {
+        pReachable[this->phi[letter]] = true;
+        Q.push(this->phi[letter]);
+      }
+    }
+    while (!Q.empty()) {
+      size_t cur = Q.front();
+      Q.pop();
+      for (size_t letter = 0; letter < this->phi.size(); ++letter) {
+        size_t next = this->sPlus.product(cur, this->phi[letter]);
+        if (!pReachable[next]) {
+          pReachable[next] = true;
+          Q.push(next);
+        }
+      }
+    }
+
+    //Generated omega elements: closure of the omega iterations under left multiplication with letter images.
+    auto oReachable = std::vector<bool>(oSize, false);
     for (size_t s = 0; s < pSize; ++s) {
-      toCheck.push_back(s);
+      if (pReachable[s] && !oReachable[this->omegaIterationTable[s]]) {
+        oReachable[this->omegaIterationTable[s]] = true;
+        Q.push(this->omegaIterationTable[s]);
+      }
     }
-    //list of representants
-    auto representantList = std::list<size_t>();
-    //vector assigning to each element the id of its equivalence class
-    auto classID = std::vector<size_t>(pSize, 0);
-    size_t currentClassID = 0;
-    //main loop
-    while(!toCheck.empty()) {
-      //process first element
-      size_t current = toCheck.front();
-      toCheck.pop_front();
-      classID[current] = currentClassID;
-      representantList.push_back(current);
-      //identify equivalent elements
-      auto iter = toCheck.begin();
-      while (iter != toCheck.end()) {
-        if (this->sPlusEquivalent(current, *iter)) {
-          classID[*iter] = currentClassID;
-          iter = toCheck.erase(iter);
+    while (!Q.empty()) {
+      size_t cur = Q.front();
+      Q.pop();
+      for (size_t letter = 0; letter < this->phi.size(); ++letter) {
+        size_t next = this->mixedProduct(this->phi[letter], cur);
+        if (!oReachable[next]) {
+          oReachable[next] = true;
+          Q.push(next);
         }
-        else {
-          ++iter;
+      }
+    }
+
+    //Compact renumbering
+    auto pIndex = std::vector<size_t>(pSize, 0);
+    auto pElements = std::vector<size_t>();
+    for (size_t s = 0; s < pSize; ++s) {
+      if (pReachable[s]) {
+        pIndex[s] = pElements.size();
+        pElements.push_back(s);
+      }
+    }
+    auto oIndex = std::vector<size_t>(oSize, 0);
+    auto oElements = std::vector<size_t>();
+    for (size_t o = 0; o < oSize; ++o) {
+      if (oReachable[o]) {
+        oIndex[o] = oElements.size();
+        oElements.push_back(o);
+      }
+    }
+    //Nothing to remove
+    if (pElements.size() == pSize && oElements.size() == oSize) {
+      return;
+    }
+    size_t pSizeReduced = pElements.size();
+    size_t oSizeReduced = oElements.size();
+
+    //Build new tables
+    auto sPlusNamesReduced = std::vector<std::string>(pSizeReduced);
+    auto productTableReduced = std::vector<std::vector<size_t> >(pSizeReduced, std::vector<size_t>(pSizeReduced, 0));
+    auto mixedTableReduced = std::vector<std::vector<size_t> >(pSizeReduced, std::vector<size_t>(oSizeReduced, 0));
+    auto omegaTableReduced = std::vector<size_t>(pSizeReduced, 0);
+    for (size_t s = 0; s < pSizeReduced; ++s) {
+      sPlusNamesReduced[s] = this->sPlus.elementName(pElements[s]);
+      for (size_t t = 0; t < pSizeReduced; ++t) {
+        productTableReduced[s][t] = pIndex[this->sPlus.product(pElements[s], pElements[t])];
+      }
+      for (size_t o = 0; o < oSizeReduced; ++o) {
+        mixedTableReduced[s][o] = oIndex[this->mixedProduct(pElements[s], oElements[o])];
+      }
+      omegaTableReduced[s] = oIndex[this->omegaIterationTable[pElements[s]]];
+    }
+    auto sOmegaNamesReduced = std::vector<std::string>(oSizeReduced);
+    auto PReduced = std::vector<bool>(oSizeReduced, false);
+    for (size_t o = 0; o < oSizeReduced; ++o) {
+      sOmegaNamesReduced[o] = this->omegaElementNames[oElements[o]];
+      PReduced[o] = this->P[oElements[o]];
+    }
+    auto imagesReduced = std::vector<size_t>(this->phi.size(), 0);
+    for (size_t letter = 0; letter < this->phi.size(); ++letter) {
+      imagesReduced[letter] = pIndex[this->phi[letter]];
+    }
+
+    //Update all members
+    this->sPlus = Semigroup(sPlusNamesReduced, productTableReduced);
+    this->omegaElementNames = sOmegaNamesReduced;
+    this->mixedProductTable = IndexTable(mixedTableReduced, oSizeReduced);
+    this->derived.reset();
+    this->omegaIterationTable = IndexTable(omegaTableReduced, oSizeReduced);
+    this->phi = Morphism(imagesReduced, this->phi.getAlphabet());
+    this->P = PReduced;
+  }
+
+  std::vector<size_t> OmegaSemigroup::rightFactors(std::vector<size_t> const& generators) const {
+    size_t pSize = this->sPlus.size();
+    size_t oSize = this->omegaElementNames.size();
+    //Every generated omega element is s * t^w, so the omega iterations suffice, plus all elements not
+    //generated this way.
+    auto rightFactors = std::vector<size_t>();
+    auto generated = std::vector<bool>(oSize, false);
+    auto Q = std::queue<size_t>();
+    for (size_t s = 0; s < pSize; ++s) {
+      size_t sOm = this->omegaIterationTable[s];
+      if (!generated[sOm]) {
+        generated[sOm] = true;
+        rightFactors.push_back(sOm);
+        Q.push(sOm);
+      }
+    }
+    while (!Q.empty()) {
+      size_t cur = Q.front();
+      Q.pop();
+      for (auto iter = generators.begin(); iter != generators.end(); ++iter) {
+        size_t next = this->mixedProduct(*iter, cur);
+        if (!generated[next]) {
+          generated[next] = true;
+          Q.push(next);
         }
       }
-      //increase class ID
-      ++currentClassID;
     }
+    for (size_t x = 0; x < oSize; ++x) {
+      if (!generated[x]) {
+        rightFactors.push_back(x);
+      }
+    }
+    return rightFactors;
+  }
 
-    //Reduce sOmega
+  std::vector<size_t> OmegaSemigroup::syntacticClasses() const {
+    size_t pSize = this->sPlus.size();
     size_t oSize = this->omegaElementNames.size();
-    //list of all element ids yet to check
-    toCheck = std::list<size_t>();
-    for (size_t s = 0; s < oSize; ++s) {
-      toCheck.push_back(s);
+    size_t states = pSize + oSize;
+
+    //Generators of sPlus, and omega elements needed as right factors of mixed products.
+    auto images = std::vector<size_t>(this->phi.size(), 0);
+    for (size_t letter = 0; letter < this->phi.size(); ++letter) {
+      images[letter] = this->phi[letter];
     }
-    //list of representants
-    auto omegaRepresentantList = std::list<size_t>();
-    //vector assigning to each element the id of its equivalence class
-    auto omegaClassID = std::vector<size_t>(oSize, 0);
-    size_t omegaCurrentClassID = 0;
-    //main loop
-    while(!toCheck.empty()) {
-      //process first element
-      size_t current = toCheck.front();
-      toCheck.pop_front();
-      omegaClassID[current] = omegaCurrentClassID;
-      omegaRepresentantList.push_back(current);
-      //identify equivalent elements
-      auto iter = toCheck.begin();
-      while (iter != toCheck.end()) {
-        if (this->sOmegaEquivalent(current, *iter)) {
-          omegaClassID[*iter] = omegaCurrentClassID;
-          iter = toCheck.erase(iter);
+    auto generators = this->sPlus.generatingSet(images);
+    auto rightFactors = this->rightFactors(generators);
+
+    //Transition function of the letters: left multiplication (both sorts), right multiplication, omega iteration
+    //and mixed product with a right factor. Undefined transitions are not stored.
+    size_t letters = 2 * generators.size() + 1 + rightFactors.size();
+    auto transition = [&](size_t letter, size_t state, size_t& target) -> bool {
+      size_t g = generators.size();
+      if (letter < g) {
+        size_t gen = generators[letter];
+        target = (state < pSize ? this->sPlus.product(gen, state) : pSize + this->mixedProduct(gen, state - pSize));
+        return true;
+      }
+      if (state >= pSize) {
+        return false;
+      }
+      if (letter < 2 * g) {
+        target = this->sPlus.product(state, generators[letter - g]);
+      }
+      else if (letter == 2 * g) {
+        target = pSize + this->omegaIterationTable[state];
+      }
+      else {
+        target = pSize + this->mixedProduct(state, rightFactors[letter - 2 * g - 1]);
+      }
+      return true;
+    };
+    //Initial blocks: sPlus, omega elements in P, omega elements not in P.
+    auto labels = std::vector<size_t>(states, 0);
+    for (size_t q = pSize; q < states; ++q) {
+      labels[q] = (this->P[q - pSize] ? 1 : 2);
+    }
+    auto blockOf = refinePartition(states, letters, transition, labels);
+
+    //Number classes of each sort in order of their least element.
+    auto classID = std::vector<size_t>(states, 0);
+    auto blockNumber = std::vector<size_t>(states, states);
+    size_t nextPlusClass = 0;
+    size_t nextOmegaClass = 0;
+    for (size_t q = 0; q < states; ++q) {
+      size_t b = blockOf[q];
+      if (blockNumber[b] == states) {
+        blockNumber[b] = (q < pSize ? nextPlusClass++ : nextOmegaClass++);
+      }
+      classID[q] = blockNumber[b];
+    }
+    return classID;
+  }
+
+  std::vector<size_t> OmegaSemigroup::syntacticClassesBySignatures(unsigned threads) const {
+    size_t pSize = this->sPlus.size();
+    size_t oSize = this->omegaElementNames.size();
+
+    //Omega signatures: bit 0 is P(x), bit s + 1 is P(s * x).
+    size_t words = (pSize + 1 + 63) / 64;
+    auto omegaSignatures = std::vector<std::vector<uint64_t> >(oSize, std::vector<uint64_t>(words, 0));
+    parallelFor(oSize, threads, [&](size_t begin, size_t end) {
+      for (size_t x = begin; x < end; ++x) {
+        auto& signature = omegaSignatures[x];
+        signature[0] = (this->P[x] ? 1 : 0);
+        for (size_t s = 0; s < pSize; ++s) {
+          signature[(s + 1) / 64] |= uint64_t(this->P[this->mixedProduct(s, x)] ? 1 : 0) << ((s + 1) % 64);
         }
-        else {
-          ++iter;
+      }
+    });
+    auto omegaClassID = groupSignatures(omegaSignatures);
+    omegaSignatures.clear();
+
+    //Right factors of mixed products, as for syntacticClasses.
+    auto images = std::vector<size_t>(this->phi.size(), 0);
+    for (size_t letter = 0; letter < this->phi.size(); ++letter) {
+      images[letter] = this->phi[letter];
+    }
+    auto rightFactors = this->rightFactors(this->sPlus.generatingSet(images));
+
+    //Right profiles: omega classes of y * z for all right factors z, and of y^w.
+    auto profiles = std::vector<std::vector<uint32_t> >(pSize, std::vector<uint32_t>(rightFactors.size() + 1, 0));
+    parallelFor(pSize, threads, [&](size_t begin, size_t end) {
+      for (size_t y = begin; y < end; ++y) {
+        auto& profile = profiles[y];
+        for (size_t u = 0; u < rightFactors.size(); ++u) {
+          profile[u] = omegaClassID[this->mixedProduct(y, rightFactors[u])];
+        }
+        profile[rightFactors.size()] = omegaClassID[this->omegaIterationTable[y]];
+      }
+    });
+    auto profileID = groupSignatures(profiles);
+    profiles.clear();
+
+    //Finite signatures: right profile classes of xt for t in S^1.
+    auto signatures = std::vector<std::vector<uint32_t> >(pSize, std::vector<uint32_t>(pSize + 1, 0));
+    parallelFor(pSize, threads, [&](size_t begin, size_t end) {
+      for (size_t x = begin; x < end; ++x) {
+        auto& signature = signatures[x];
+        signature[0] = profileID[x];
+        for (size_t t = 0; t < pSize; ++t) {
+          signature[t + 1] = profileID[this->sPlus.product(x, t)];
         }
       }
-      //increase class ID
-      ++omegaCurrentClassID;
+    });
+    auto classID = groupSignatures(signatures);
+
+    classID.insert(classID.end(), omegaClassID.begin(), omegaClassID.end());
+    return classID;
+  }
+
+  void OmegaSemigroup::reduceToSyntactic(bool useSignatures, unsigned threads) {
+    size_t pSize = this->sPlus.size();
+    size_t oSize = this->omegaElementNames.size();
+    auto classes = (useSignatures ? this->syntacticClassesBySignatures(threads) : this->syntacticClasses());
+
+    //Split class ids by sort and pick the least element of each class as representant
+    auto classID = std::vector<size_t>(classes.begin(), classes.begin() + pSize);
+    auto omegaClassID = std::vector<size_t>(classes.begin() + pSize, classes.end());
+    auto representantList = std::list<size_t>();
+    auto omegaRepresentantList = std::list<size_t>();
+    for (size_t s = 0; s < pSize; ++s) {
+      if (classID[s] == representantList.size()) {
+        representantList.push_back(s);
+      }
+    }
+    for (size_t x = 0; x < oSize; ++x) {
+      if (omegaClassID[x] == omegaRepresentantList.size()) {
+        omegaRepresentantList.push_back(x);
+      }
     }
 
     //turn representants into vectors
@@ -134,7 +429,7 @@ namespace omalg {
       for (size_t oClass = 0; oClass < oSizeReduced; ++oClass) {
         size_t pRep = representants[pClass];
         size_t oRep = omegaRepresentants[oClass];
-        mixedTableReduced[pClass][oClass] = omegaClassID[this->mixedProductTable[pRep][oRep]];
+        mixedTableReduced[pClass][oClass] = omegaClassID[this->mixedProduct(pRep, oRep)];
       }
     }
 
@@ -161,56 +456,75 @@ namespace omalg {
     //Update all members
     this->sPlus = Semigroup(sPlusNamesReduced, productTableReduced);
     this->omegaElementNames = sOmegaNamesReduced;
-    this->mixedProductTable = mixedTableReduced;
-    this->omegaIterationTable = omegaTableReduced;
+    this->mixedProductTable = IndexTable(mixedTableReduced, oSizeReduced);
+    this->derived.reset();
+    this->omegaIterationTable = IndexTable(omegaTableReduced, oSizeReduced);
     this->phi = phiReduced;
     this->P = PReduced;
   }
 
-  bool OmegaSemigroup::sPlusEquivalent(size_t lhs, size_t rhs) const {
-    size_t sPlusSize = this->sPlus.size();
-    //Check first condition
-    for (size_t s = 0; s < sPlusSize; ++s) {
-      for (size_t t = 0; t < sPlusSize; ++t) {
-        for (size_t u = 0; u < sPlusSize; ++u) {
-          //Compare s * lhs * t * u^w and s * rhs * t * u^w
-          size_t leftProd = this->mixedProductTable[this->sPlus.product(s, this->sPlus.product(lhs, t))][this->omegaIterationTable[u]];
-          size_t rightProd = this->mixedProductTable[this->sPlus.product(s, this->sPlus.product(rhs, t))][this->omegaIterationTable[u]];
-          if (this->P[leftProd] != this->P[rightProd]) {
-            return false;
-          }
-        }
-      }
+  unsigned OmegaSemigroup::landweberClasses() const {
+    this->sPlus.calculateROrder();
+    auto const& linkedPairs = this->sPlus.linkedPairs();
+
+    //Acceptance bit of se^w for each linked pair (s,e), in the order of the list.
+    auto pairs = std::vector<std::pair<size_t, size_t> >(linkedPairs.begin(), linkedPairs.end());
+    auto acceptingPair = std::vector<bool>(pairs.size(), false);
+    for (size_t i = 0; i < pairs.size(); ++i) {
+      acceptingPair[i] = this->P[this->mixedProduct(pairs[i].first, this->omegaIterationTable[pairs[i].second])];
     }
-    //Check second condition
-    for (size_t s = 0; s < sPlusSize; ++s) {
-      for (size_t t = 0; t < sPlusSize; ++t) {
-        //Compare s(lhs * t)^w and s(rhs * t)^w
-        size_t leftProd = this->mixedProductTable[s][this->omegaIterationTable[this->sPlus.product(lhs, t)]];
-        size_t rightProd = this->mixedProductTable[s][this->omegaIterationTable[this->sPlus.product(rhs, t)]];
-        if (this->P[leftProd] != this->P[rightProd]) {
-          return false;
+
+    //DB is violated by linked pairs (s,e), (s,f) with e <=_r f, sf^w in P and se^w not in P. DC is the dual.
+    //Pairs with equal s are consecutive in the list.
+    bool db = true;
+    bool dc = true;
+    for (size_t i = 0; i < pairs.size() && (db || dc); ++i) {
+      for (size_t j = i + 1; j < pairs.size() && pairs[j].first == pairs[i].first; ++j) {
+        if (acceptingPair[i] == acceptingPair[j]) {
+          continue;
+        }
+        //Let e be the rejecting and f the accepting idempotent.
+        size_t e = (acceptingPair[i] ? pairs[j].second : pairs[i].second);
+        size_t f = (acceptingPair[i] ? pairs[i].second : pairs[j].second);
+        if (this->sPlus.r(e, f)) {
+          db = false;
+        }
+        if (this->sPlus.r(f, e)) {
+          dc = false;
         }
       }
     }
-    return true;
+
+    unsigned result = 0;
+    if (db) {
+      result |= DB;
+    }
+    if (dc) {
+      result |= DC;
+    }
+    if (db && dc) {
+      result |= WB;
+    }
+    //E and A on the R order DAG
+    result |= this->eaClasses();
+    return result;
   }
 
-  bool OmegaSemigroup::sOmegaEquivalent(size_t lhs, size_t rhs) const {
-    for (size_t s = 0; s < this->sPlus.size(); ++s) {
-      //Compare s * lhs and s * rhs
-      size_t leftProd = this->mixedProductTable[s][lhs];
-      size_t rightProd = this->mixedProductTable[s][rhs];
-      if (this->P[leftProd] != this->P[rightProd]) {
-        return false;
-      }
+  bool OmegaSemigroup::isAperiodic() const {
+    auto images = std::vector<size_t>(this->phi.size(), 0);
+    for (size_t letter = 0; letter < this->phi.size(); ++letter) {
+      images[letter] = this->phi[letter];
     }
-    return true;
+    return this->sPlus.isAperiodic(this->sPlus.generatingSet(images));
   }
 
   bool OmegaSemigroup::isDBRecognizable() const {
+    return this->isDBRecognizable(false);
+  }
+
+  bool OmegaSemigroup::isDBRecognizable(bool complement) const {
     this->sPlus.calculateROrder();
-    auto linkedPairs = this->sPlus.linkedPairs();
+    auto const& linkedPairs = this->sPlus.linkedPairs();
     //Check all linked pairs (s,e) and (s,f) for the condition. This makes use of the list of linked pairs being sorted.
     for (auto iter1 = linkedPairs.begin(); iter1 != linkedPairs.end(); ++iter1) {
       for (auto iter2 = iter1; iter2 != linkedPairs.end() && iter2->first == iter1->first ; ++iter2) {
@@ -223,11 +537,11 @@ namespace omalg {
         auto eOm = this->omegaIterationTable[e];
         auto fOm = this->omegaIterationTable[f];
         //Check if e <=_r f, sf^w in P, se^w not in P. In this case the condition is violated.
-        if (this->sPlus.r(e, f) && this->P[this->mixedProductTable[s][fOm]] && !this->P[this->mixedProductTable[s][eOm]]) {
+        if (this->sPlus.r(e, f) && this->accepting(this->mixedProduct(s, fOm), complement) && !this->accepting(this->mixedProduct(s, eOm), complement)) {
           return false;
         }
         //Check the same for f and e switching roles.
-        if (this->sPlus.r(f, e) && this->P[this->mixedProductTable[s][eOm]] && !this->P[this->mixedProductTable[s][fOm]]) {
+        if (this->sPlus.r(f, e) && this->accepting(this->mixedProduct(s, eOm), complement) && !this->accepting(this->mixedProduct(s, fOm), complement)) {
           return false;
         }
       }
@@ -236,39 +550,81 @@ namespace omalg {
   }
 
   bool OmegaSemigroup::isDCRecognizable() const {
-    OmegaSemigroup comp = *this;
-    comp.invertP();
-    return comp.isDBRecognizable();
+    return this->isDBRecognizable(true);
   }
 
-  bool OmegaSemigroup::isERecognizable() const {
-    this->sPlus.calculateROrder();
-    auto linkedPairs = this->sPlus.linkedPairs();
-    //Check all linked pairs (s,e) and (t,f) for the condition.
-    for (auto iter1 = linkedPairs.begin(); iter1 != linkedPairs.end(); ++iter1) {
-      for (auto iter2 = linkedPairs.begin(); iter2 != linkedPairs.end(); ++iter2) {
-        if (iter2 == iter1) {
-          continue;
-        }
-        auto s = iter1->first;
-        auto t = iter2->first;
-        auto e = iter1->second;
-        auto f = iter2->second;
-        auto eOm = this->omegaIterationTable[e];
-        auto fOm = this->omegaIterationTable[f];
-        //check if s <=_r t, tf^w in P and se^w not in P. Then the condition is violated.
-        if (this->sPlus.r(s,t) && this->P[this->mixedProductTable[t][fOm]] && !this->P[this->mixedProductTable[s][eOm]]) {
-          return false;
+  unsigned OmegaSemigroup::eaClasses() const {
+    size_t pSize = this->sPlus.size();
+    //R order DAG: components of the right Cayley graph over a generating set.
+    auto images = std::vector<size_t>(this->phi.size(), 0);
+    for (size_t letter = 0; letter < this->phi.size(); ++letter) {
+      images[letter] = this->phi[letter];
+    }
+    auto generators = this->sPlus.generatingSet(images);
+    auto graph = std::vector<std::vector<size_t> >(pSize, std::vector<size_t>(generators.size(), 0));
+    for (size_t s = 0; s < pSize; ++s) {
+      for (size_t g = 0; g < generators.size(); ++g) {
+        graph[s][g] = this->sPlus.product(s, generators[g]);
+      }
+    }
+    auto component = stronglyConnectedComponents(graph);
+    size_t components = 0;
+    for (size_t s = 0; s < pSize; ++s) {
+      components = std::max(components, component[s] + 1);
+    }
+
+    //Accepting and rejecting linked pairs in each R class
+    auto accepting = std::vector<bool>(components, false);
+    auto rejecting = std::vector<bool>(components, false);
+    auto const& linkedPairs = this->sPlus.linkedPairs();
+    for (auto iter = linkedPairs.begin(); iter != linkedPairs.end(); ++iter) {
+      if (this->P[this->mixedProduct(iter->first, this->omegaIterationTable[iter->second])]) {
+        accepting[component[iter->first]] = true;
+      }
+      else {
+        rejecting[component[iter->first]] = true;
+      }
+    }
+
+    //Propagate to R classes above. Edges lead to components with smaller index, so increasing order suffices.
+    auto members = std::vector<std::vector<size_t> >(components);
+    for (size_t s = 0; s < pSize; ++s) {
+      members[component[s]].push_back(s);
+    }
+    auto acceptingBelow = accepting;
+    auto rejectingBelow = rejecting;
+    bool e = true;
+    bool a = true;
+    for (size_t c = 0; c < components; ++c) {
+      for (auto sIter = members[c].begin(); sIter != members[c].end(); ++sIter) {
+        for (auto tIter = graph[*sIter].begin(); tIter != graph[*sIter].end(); ++tIter) {
+          acceptingBelow[c] = acceptingBelow[c] || acceptingBelow[component[*tIter]];
+          rejectingBelow[c] = rejectingBelow[c] || rejectingBelow[component[*tIter]];
         }
       }
+      if (accepting[c] && rejectingBelow[c]) {
+        e = false;
+      }
+      if (rejecting[c] && acceptingBelow[c]) {
+        a = false;
+      }
     }
-    return true;
+    unsigned result = 0;
+    if (e) {
+      result |= E;
+    }
+    if (a) {
+      result |= A;
+    }
+    return result;
+  }
+
+  bool OmegaSemigroup::isERecognizable() const {
+    return (this->eaClasses() & E) != 0;
   }
 
   bool OmegaSemigroup::isARecognizable() const {
-    OmegaSemigroup comp = *this;
-    comp.invertP();
-    return comp.isERecognizable();
+    return (this->eaClasses() & A) != 0;
   }
 
   bool OmegaSemigroup::isWBRecognizable() const {
@@ -284,27 +640,105 @@ namespace omalg {
     return Converter.convertToWeakBuechi();
   }
 
-  DeterministicCoBuechiAutomaton OmegaSemigroup::toCoBuechi() const {
+  void OmegaSemigroup::toWeakBuechi(AutomatonSink& sink) const {
+    if (!this->isWBRecognizable()) {
+      throw OperationNotApplicableException();
+    }
+    AutomatonConverter(*this).convertToWeakBuechi(sink);
+  }
+
+  DeterministicCoBuechiAutomaton OmegaSemigroup::toCoBuechi(unsigned threads) const {
     if (!this->isDCRecognizable()) {
       throw OperationNotApplicableException();
     }
-    auto Converter = AutomatonConverter(*this);
+    auto Converter = AutomatonConverter(*this, false, threads);
     return Converter.convertToCoBuechi();
   }
 
-  DeterministicBuechiAutomaton OmegaSemigroup::toDetBuechi() const {
+  void OmegaSemigroup::toCoBuechi(AutomatonSink& sink, unsigned threads) const {
+    if (!this->isDCRecognizable()) {
+      throw OperationNotApplicableException();
+    }
+    AutomatonConverter(*this, false, threads).convertToCoBuechi(sink);
+  }
+
+  DeterministicBuechiAutomaton OmegaSemigroup::toDetBuechi(unsigned threads) const {
     if (!this->isDBRecognizable()) {
       throw OperationNotApplicableException();
     }
-    auto Converter = AutomatonConverter(*this);
+    auto Converter = AutomatonConverter(*this, false, threads);
     return Converter.convertToDetBuechi();
   }
 
-  DeterministicParityAutomaton OmegaSemigroup::toParity() const {
-    auto Converter = AutomatonConverter(*this);
+  void OmegaSemigroup::toDetBuechi(AutomatonSink& sink, unsigned threads) const {
+    if (!this->isDBRecognizable()) {
+      throw OperationNotApplicableException();
+    }
+    AutomatonConverter(*this, false, threads).convertToDetBuechi(sink);
+  }
+
+  DeterministicParityAutomaton OmegaSemigroup::toParity(unsigned threads) const {
+    auto Converter = AutomatonConverter(*this, false, threads);
     return Converter.convertToParity();
   }
 
+  void OmegaSemigroup::toParity(AutomatonSink& sink, unsigned threads) const {
+    AutomatonConverter(*this, false, threads).convertToParity(sink);
+  }
+
+  NondeterministicBuechiAutomaton OmegaSemigroup::toNondeterministicBuechi(bool reduce) const {
+    auto Converter = AutomatonConverter(*this);
+    return Converter.convertToNondeterministicBuechi(reduce);
+  }
+
+  unsigned OmegaSemigroup::toAutomata(AutomatonSink* weakBuechi, AutomatonSink* coBuechi, AutomatonSink* detBuechi,
+                                      AutomatonSink* parity, unsigned threads) const {
+    unsigned classes = this->landweberClasses();
+    auto Converter = AutomatonConverter(*this, false, threads);
+    Converter.convertToAll((classes & WB) ? weakBuechi : nullptr, (classes & DC) ? coBuechi : nullptr,
+                           (classes & DB) ? detBuechi : nullptr, parity);
+    return classes;
+  }
+
+  std::string OmegaSemigroup::axiomViolation() const {
+    size_t pSize = this->sPlus.size();
+    size_t oSize = this->omegaElementNames.size();
+    auto images = std::vector<size_t>(this->phi.size(), 0);
+    for (size_t letter = 0; letter < this->phi.size(); ++letter) {
+      images[letter] = this->phi[letter];
+    }
+    auto generators = this->sPlus.generatingSet(images);
+
+    //Light's test for sPlus
+    if (!this->sPlus.isAssociative(generators)) {
+      return "Product table is not associative.";
+    }
+    //The set of s with s(tx) = (st)x for all t, x is closed under product, so generators suffice.
+    for (auto iter = generators.begin(); iter != generators.end(); ++iter) {
+      for (size_t t = 0; t < pSize; ++t) {
+        size_t st = this->sPlus.product(*iter, t);
+        for (size_t x = 0; x < oSize; ++x) {
+          if (this->mixedProduct(*iter, this->mixedProduct(t, x)) != this->mixedProduct(st, x)) {
+            return "Mixed product violates s(tx) = (st)x for s = " + this->sPlus.elementName(*iter)
+                   + ", t = " + this->sPlus.elementName(t) + ", x = " + this->omegaElementNames[x] + ".";
+          }
+        }
+      }
+    }
+    //The same holds for the set of s with s(ts)^w = (st)^w for all t, given the previous axiom.
+    for (auto iter = generators.begin(); iter != generators.end(); ++iter) {
+      for (size_t t = 0; t < pSize; ++t) {
+        size_t ts = this->sPlus.product(t, *iter);
+        size_t st = this->sPlus.product(*iter, t);
+        if (this->mixedProduct(*iter, this->omegaIterationTable[ts]) != this->omegaIterationTable[st]) {
+          return "Omega iteration violates s(ts)^w = (st)^w for s = " + this->sPlus.elementName(*iter)
+                 + ", t = " + this->sPlus.elementName(t) + ".";
+        }
+      }
+    }
+    return "";
+  }
+
   std::string OmegaSemigroup::description() const {
     //Finite part
     std::string sPlusDescription = this->sPlus.description();
@@ -321,18 +755,18 @@ namespace omalg {
     
     //Mixed product table
     std::string mixedTable = "";
-    for(auto outerIter = this->mixedProductTable.begin(); outerIter != this->mixedProductTable.end(); ++outerIter) {
+    for (size_t row = 0; row < this->sPlus.size(); ++row) {
       //Add newline, but not at beginning
-      if (outerIter != this->mixedProductTable.begin()) {
+      if (row != 0) {
         mixedTable += "\n";
       }
       //Write table line
-      for(auto innerIter = outerIter->begin(); innerIter != outerIter->end(); ++innerIter) {
+      for (size_t column = 0; column < this->omegaElementNames.size(); ++column) {
         //Add ',', but not at beginnning
-        if (!mixedTable.empty() && mixedTable.back() != '\n') {
+        if (column != 0) {
           mixedTable += ",";
         }
-        mixedTable += this->omegaElementNames[*innerIter];
+        mixedTable += this->omegaElementNames[this->mixedProduct(row, column)];
       }
     }
     //Add final ';'
@@ -340,11 +774,11 @@ namespace omalg {
     
     //Omega iteration table
     std::string omegaTable = "";
-    for (auto iter = this->omegaIterationTable.begin(); iter != this->omegaIterationTable.end(); ++iter) {
-      if (iter != this->omegaIterationTable.begin()) {
+    for (size_t element = 0; element < this->omegaIterationTable.columnCount(); ++element) {
+      if (element != 0) {
         omegaTable += ",";
       }
-      omegaTable += this->omegaElementNames[*iter];
+      omegaTable += this->omegaElementNames[this->omegaIterationTable[element]];
     }
     omegaTable += ";";
     
@@ -370,8 +804,10 @@ namespace omalg {
         PList += ",";
       }
     }
-    //Remove final ',' and set ';' instead.
-    PList.pop_back();
+    //Remove final ',' and set ';' instead. P may be empty.
+    if (!PList.empty()) {
+      PList.pop_back();
+    }
     PList += ";";
     
     return sPlusDescription + "\n" + omegaElementList + "\n" + 
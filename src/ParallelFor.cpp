@@ -0,0 +1,27 @@
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "ParallelFor.h"
+
+namespace omalg {
+
+  void parallelFor(size_t count, unsigned threads, std::function<void(size_t, size_t)> const& body) {
+    if (threads == 0) {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (threads == 1 || count < 2 * threads) {
+      body(0, count);
+      return;
+    }
+    auto workers = std::vector<std::thread>();
+    size_t chunk = (count + threads - 1) / threads;
+    for (size_t begin = 0; begin < count; begin += chunk) {
+      workers.push_back(std::thread(body, begin, std::min(count, begin + chunk)));
+    }
+    for (auto iter = workers.begin(); iter != workers.end(); ++iter) {
+      iter->join();
+    }
+  }
+
+}
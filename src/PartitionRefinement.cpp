@@ -0,0 +1,145 @@
+#include <algorithm>
+
+#include "PartitionRefinement.h"
+
+namespace omalg {
+
+  std::vector<size_t> refinePartition(size_t states, size_t letters,
+                                      std::function<bool(size_t, size_t, size_t&)> const& transition,
+                                      std::vector<size_t> const& labels) {
+    //Store preimages of all letters in one compressed row per target: the pairs (letter, state) of the
+    //transitions into q are at [preimageBegin[q], preimageBegin[q+1]), so memory is linear in the transitions.
+    auto preimageBegin = std::vector<size_t>(states + 1, 0);
+    size_t target;
+    for (size_t c = 0; c < letters; ++c) {
+      for (size_t q = 0; q < states; ++q) {
+        if (transition(c, q, target)) {
+          ++preimageBegin[target + 1];
+        }
+      }
+    }
+    for (size_t q = 0; q < states; ++q) {
+      preimageBegin[q + 1] += preimageBegin[q];
+    }
+    auto preimages = std::vector<std::pair<size_t, size_t> >(preimageBegin[states]);
+    {
+      auto fill = std::vector<size_t>(preimageBegin.begin(), preimageBegin.end() - 1);
+      for (size_t c = 0; c < letters; ++c) {
+        for (size_t q = 0; q < states; ++q) {
+          if (transition(c, q, target)) {
+            preimages[fill[target]++] = std::make_pair(c, q);
+          }
+        }
+      }
+    }
+
+    //Refinable partition: the elements of each block are stored consecutively, marked elements at the front.
+    auto elements = std::vector<size_t>(states);
+    auto location = std::vector<size_t>(states);
+    auto blockOf = std::vector<size_t>(states);
+    auto blockBegin = std::vector<size_t>();
+    auto blockEnd = std::vector<size_t>();
+    auto marked = std::vector<size_t>();
+    auto inWorklist = std::vector<bool>();
+    auto worklist = std::vector<size_t>();
+    //Initial blocks: states with equal labels, in increasing order of labels.
+    auto order = std::vector<size_t>(states);
+    for (size_t q = 0; q < states; ++q) {
+      order[q] = q;
+    }
+    std::stable_sort(order.begin(), order.end(), [&labels](size_t lhs, size_t rhs) { return labels[lhs] < labels[rhs]; });
+    for (size_t position = 0; position < states; ++position) {
+      size_t q = order[position];
+      if (position == 0 || labels[q] != labels[order[position - 1]]) {
+        worklist.push_back(blockBegin.size());
+        blockBegin.push_back(position);
+        blockEnd.push_back(position);
+        marked.push_back(0);
+        inWorklist.push_back(true);
+      }
+      elements[position] = q;
+      location[q] = position;
+      blockOf[q] = blockBegin.size() - 1;
+      ++blockEnd.back();
+    }
+
+    auto touched = std::vector<size_t>();
+    auto splitter = std::vector<std::pair<size_t, size_t> >();
+    while (!worklist.empty()) {
+      size_t block = worklist.back();
+      worklist.pop_back();
+      inWorklist[block] = false;
+      //Preimages of the splitter, grouped by letter.
+      splitter.clear();
+      for (size_t position = blockBegin[block]; position < blockEnd[block]; ++position) {
+        size_t q = elements[position];
+        splitter.insert(splitter.end(), preimages.begin() + preimageBegin[q], preimages.begin() + preimageBegin[q + 1]);
+      }
+      std::sort(splitter.begin(), splitter.end());
+      for (size_t group = 0; group < splitter.size(); ) {
+        size_t c = splitter[group].first;
+        //Mark all preimages of the splitter under c
+        for (; group < splitter.size() && splitter[group].first == c; ++group) {
+          size_t q = splitter[group].second;
+          size_t b = blockOf[q];
+          if (location[q] < blockBegin[b] + marked[b]) {
+            continue;
+          }
+          if (marked[b] == 0) {
+            touched.push_back(b);
+          }
+          //Swap q to the end of the marked part
+          size_t target = blockBegin[b] + marked[b];
+          size_t other = elements[target];
+          elements[target] = q;
+          elements[location[q]] = other;
+          location[other] = location[q];
+          location[q] = target;
+          ++marked[b];
+        }
+        //Split touched blocks into marked and unmarked part
+        for (auto iter = touched.begin(); iter != touched.end(); ++iter) {
+          size_t b = *iter;
+          size_t split = blockBegin[b] + marked[b];
+          marked[b] = 0;
+          if (split == blockEnd[b]) {
+            continue;
+          }
+          size_t newBlock = blockBegin.size();
+          blockBegin.push_back(blockBegin[b]);
+          blockEnd.push_back(split);
+          marked.push_back(0);
+          inWorklist.push_back(false);
+          blockBegin[b] = split;
+          for (size_t i = blockBegin[newBlock]; i < blockEnd[newBlock]; ++i) {
+            blockOf[elements[i]] = newBlock;
+          }
+          //Hopcroft's rule: if b is still to be processed, both parts are. Otherwise the smaller part suffices.
+          if (inWorklist[b] || blockEnd[newBlock] - blockBegin[newBlock] <= blockEnd[b] - blockBegin[b]) {
+            worklist.push_back(newBlock);
+            inWorklist[newBlock] = true;
+          }
+          else {
+            worklist.push_back(b);
+            inWorklist[b] = true;
+          }
+        }
+        touched.clear();
+      }
+    }
+
+    //Number blocks in order of their least state.
+    auto blockNumber = std::vector<size_t>(blockBegin.size(), states);
+    size_t nextBlock = 0;
+    auto result = std::vector<size_t>(states, 0);
+    for (size_t q = 0; q < states; ++q) {
+      size_t b = blockOf[q];
+      if (blockNumber[b] == states) {
+        blockNumber[b] = nextBlock++;
+      }
+      result[q] = blockNumber[b];
+    }
+    return result;
+  }
+
+}
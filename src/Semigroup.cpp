@@ -1,83 +1,76 @@
+#include <algorithm>
 #include <queue>
+#include <unordered_set>
 
 #include "Semigroup.h"
+#include "StronglyConnectedComponents.h"
 
 namespace omalg {
 
+  Semigroup::Invariants::Invariants()
+    : rOrderReady(false), lOrderReady(false), jOrderReady(false),
+      jDepthsReady(false), idempotentsReady(false), linkedPairsReady(false), powerStructureReady(false) { }
+
   Semigroup::Semigroup(std::vector<std::string> theElementNames, std::vector<std::vector<size_t> > theMultiplicationTable)
-    : elementNames(theElementNames), multiplicationTable(theMultiplicationTable) { }
+    : elementNames(theElementNames), multiplicationTable(theMultiplicationTable, theElementNames.size()),
+      cache(new Invariants()) { }
 
   Semigroup::Semigroup(Semigroup const& S)
-    : elementNames(S.elementNames), multiplicationTable(S.multiplicationTable) {
-    if (S.rOrder) {
-      rOrder = new std::vector<std::vector<bool> >();
-      *rOrder = *S.rOrder;
-    }
-    else {
-      rOrder = 0;
-    }
-    if (S.lOrder) {
-      lOrder = new std::vector<std::vector<bool> >();
-      *lOrder = *S.lOrder;
-    }
-    else {
-      lOrder = 0;
-    }
-    if (S.jOrder) {
-      jOrder = new std::vector<std::vector<bool> >();
-      *jOrder = *S.jOrder;
-    }
-    else {
-      jOrder = 0;
-    }
-    if (S.jDepths) {
-      jDepths = new std::vector<size_t>();
-      *jDepths = *S.jDepths;
-    }
-    else {
-      jDepths = 0;
-    }
+    : elementNames(S.elementNames), multiplicationTable(S.multiplicationTable), cache(new Invariants()) {
+    this->copyInvariants(S);
   }
 
   Semigroup& Semigroup::operator=(Semigroup const& S) {
     if (&S != this) {
       this->elementNames = S.elementNames;
       this->multiplicationTable = S.multiplicationTable;
-      if (S.rOrder) {
-        this->rOrder = new std::vector<std::vector<bool> >();
-        *(this->rOrder) = *S.rOrder;
-      }
-      else {
-        this->rOrder = 0;
-      }
-      if (S.lOrder) {
-        this->lOrder = new std::vector<std::vector<bool> >();
-        *(this->lOrder) = *S.lOrder;
-      }
-      else {
-        this->lOrder = 0;
-      }
-      if (S.jOrder) {
-        this->jOrder = new std::vector<std::vector<bool> >();
-        *(this->jOrder) = *S.jOrder;
-      }
-      else {
-        this->jOrder = 0;
-      }
-      if (S.jDepths) {
-        this->jDepths = new std::vector<size_t>();
-        *(this->jDepths) = *S.jDepths;
-      }
-      else {
-        this->jDepths = 0;
-      }
+      //Once flags can not be reset, so the invariants are replaced as a whole.
+      this->cache.reset(new Invariants());
+      this->copyInvariants(S);
     }
     return *this;
+  }
 
+  void Semigroup::copyInvariants(Semigroup const& S) {
+    //Only copy what S has finished computing. Running the copies through the once flags marks them as done.
+    Invariants& source = *S.cache;
+    Invariants& target = *this->cache;
+    if (source.rOrderReady) {
+      std::call_once(target.rOrderFlag, [&]() { target.rOrder = source.rOrder; target.rOrderReady = true; });
+    }
+    if (source.lOrderReady) {
+      std::call_once(target.lOrderFlag, [&]() { target.lOrder = source.lOrder; target.lOrderReady = true; });
+    }
+    if (source.jOrderReady) {
+      std::call_once(target.jOrderFlag, [&]() { target.jOrder = source.jOrder; target.jOrderReady = true; });
+    }
+    if (source.jDepthsReady) {
+      std::call_once(target.jDepthsFlag, [&]() { target.jDepths = source.jDepths; target.jDepthsReady = true; });
+    }
+    if (source.idempotentsReady) {
+      std::call_once(target.idempotentsFlag, [&]() {
+        target.idempotents = source.idempotents;
+        target.idempotentsReady = true;
+      });
+    }
+    if (source.linkedPairsReady) {
+      std::call_once(target.linkedPairsFlag, [&]() {
+        target.linkedPairs = source.linkedPairs;
+        target.linkedPairsReady = true;
+      });
+    }
+    if (source.powerStructureReady) {
+      std::call_once(target.powerStructureFlag, [&]() {
+        target.powerIndices = source.powerIndices;
+        target.powerPeriods = source.powerPeriods;
+        target.idempotentPowers = source.idempotentPowers;
+        target.powerStructureReady = true;
+      });
+    }
   }
 
   size_t Semigroup::product(size_t lhs, size_t rhs) const {
-    return this->multiplicationTable[lhs][rhs];
+    return this->multiplicationTable(lhs, rhs);
   }
 
   size_t Semigroup::size() const {
@@ -94,62 +87,78 @@ namespace omalg {
   
   void Semigroup::calculateGreenRelations() const {
     //The runtime is O(n^2) for the l and r order and O(n^3) for the j order.
-    //calculate r order
-    if (!this->rOrder || !this->lOrder) {
-      //initialize l and r order
-      this->rOrder = new std::vector<std::vector<bool> >(this->elementNames.size(), std::vector<bool>(this->elementNames.size(), false));
-      this->lOrder = new std::vector<std::vector<bool> >(this->elementNames.size(), std::vector<bool>(this->elementNames.size(), false));
-
-      //calculate l and r order
-      for (size_t i = 0; i < this->elementNames.size(); ++i) {
-        for (size_t j = 0; j < this->elementNames.size(); ++j) {
-          auto k = this->multiplicationTable[i][j];
-          (*(this->lOrder))[k][j] = true;
-          (*(this->rOrder))[k][i] = true;
-
-        }
-      }
-    }
-    if(!this->jOrder) {
+    this->calculateROrder();
+    this->calculateLOrder();
+    std::call_once(this->cache->jOrderFlag, [this]() {
+      size_t size = this->elementNames.size();
+      auto const& rOrder = this->cache->rOrder;
+      auto const& lOrder = this->cache->lOrder;
       //initialize j order
-      this->jOrder = new std::vector<std::vector<bool> >(this->elementNames.size(), std::vector<bool>(this->elementNames.size(), false));
+      auto jOrder = std::vector<std::vector<bool> >(size, std::vector<bool>(size, false));
 
       //calculate j order
-      for (size_t i = 0; i < this->elementNames.size(); ++i) {
-        for (size_t j = 0; j < this->elementNames.size(); ++j) {
-          for (size_t k = 0; k < this->elementNames.size(); ++k) {
-            if ((*(this->lOrder))[k][j] && (*(this->rOrder))[i][k]) {
-              (*(this->jOrder))[i][j] = true;
+      for (size_t i = 0; i < size; ++i) {
+        for (size_t j = 0; j < size; ++j) {
+          for (size_t k = 0; k < size; ++k) {
+            if (lOrder[k][j] && rOrder[i][k]) {
+              jOrder[i][j] = true;
               break;
             }
           }
         }
       }
-    }
+      this->cache->jOrder.swap(jOrder);
+      this->cache->jOrderReady = true;
+    });
   }
 
   void Semigroup::calculateROrder() const {
-    if (!this->rOrder) {
+    std::call_once(this->cache->rOrderFlag, [this]() {
+      size_t size = this->elementNames.size();
       //initialize
-      this->rOrder = new std::vector<std::vector<bool> >(this->elementNames.size(), std::vector<bool>(this->elementNames.size(), false));
+      auto rOrder = std::vector<std::vector<bool> >(size, std::vector<bool>(size, false));
       //calculate rOrder
-      for (size_t i = 0; i < this->elementNames.size(); ++i) {
-        for (size_t j = 0; j < this->elementNames.size(); ++j) {
-          auto k = this->multiplicationTable[i][j];
-          (*(this->rOrder))[k][i] = true;
+      for (size_t i = 0; i < size; ++i) {
+        for (size_t j = 0; j < size; ++j) {
+          auto k = this->multiplicationTable(i, j);
+          rOrder[k][i] = true;
         }
       }
-    }
+      this->cache->rOrder.swap(rOrder);
+      this->cache->rOrderReady = true;
+    });
+  }
+
+  void Semigroup::calculateLOrder() const {
+    std::call_once(this->cache->lOrderFlag, [this]() {
+      size_t size = this->elementNames.size();
+      //initialize
+      auto lOrder = std::vector<std::vector<bool> >(size, std::vector<bool>(size, false));
+      //calculate lOrder
+      for (size_t i = 0; i < size; ++i) {
+        for (size_t j = 0; j < size; ++j) {
+          auto k = this->multiplicationTable(i, j);
+          lOrder[k][j] = true;
+        }
+      }
+      this->cache->lOrder.swap(lOrder);
+      this->cache->lOrderReady = true;
+    });
   }
 
   void Semigroup::calculateJDepths() const {
     //Calculate jOrder first
-    if (!this->jOrder) {
-      this->calculateGreenRelations();
-    }
+    this->calculateGreenRelations();
+    std::call_once(this->cache->jDepthsFlag, [this]() {
+      this->cache->jDepths = this->computeJDepths();
+      this->cache->jDepthsReady = true;
+    });
+  }
+
+  std::vector<size_t> Semigroup::computeJDepths() const {
     size_t size = this->elementNames.size();
     //Allocate memory
-    this->jDepths = new std::vector<size_t>(size, 0);
+    auto jDepths = std::vector<size_t>(size, 0);
 
     //calculate strict j order
     auto strictJOrder = std::vector<std::vector<bool>>(size, std::vector<bool>(size, false));
@@ -189,13 +198,13 @@ namespace omalg {
       Q.pop();
       //assign j depth to maximum depth of higher elements + 1
       for (auto iter = higher[cur].begin(); iter != higher[cur].end(); ++iter) {
-        if ((*(this->jDepths))[cur] == 0 || (*(this->jDepths))[cur] < (*(this->jDepths))[*iter] + 1) {
-          (*(this->jDepths))[cur] = (*(this->jDepths))[*iter] + 1;
+        if (jDepths[cur] == 0 || jDepths[cur] < jDepths[*iter] + 1) {
+          jDepths[cur] = jDepths[*iter] + 1;
         }
       }
       //Special case: depth 1. There are no higher elements.
-      if((*(this->jDepths))[cur] == 0) {
-        (*(this->jDepths))[cur] = 1;
+      if(jDepths[cur] == 0) {
+        jDepths[cur] = 1;
       }
       //Decrease count for all lower elements.
       for (auto iter = lower[cur].begin(); iter != lower[cur].end(); ++iter) {
@@ -206,7 +215,7 @@ namespace omalg {
         }
       }
     }
-
+    return jDepths;
   }
 
   bool Semigroup::J(size_t lhs, size_t rhs) const {
@@ -226,8 +235,8 @@ namespace omalg {
   }
 
   bool Semigroup::j(size_t lhs, size_t rhs) const {
-    if (this->jOrder) {
-      return (*(this->jOrder))[lhs][rhs];
+    if (this->cache->jOrderReady) {
+      return this->cache->jOrder[lhs][rhs];
     }
     else {
       for (size_t iter = 0; iter < this->elementNames.size(); ++iter) {
@@ -240,22 +249,26 @@ namespace omalg {
   }
 
   bool Semigroup::r(size_t lhs, size_t rhs) const {
-    if (this->rOrder) {
-      return (*(this->rOrder))[lhs][rhs];
+    if (this->cache->rOrderReady) {
+      return this->cache->rOrder[lhs][rhs];
     }
     else {
-      return (std::find(this->multiplicationTable[rhs].begin(), this->multiplicationTable[rhs].end(), lhs)
-              != this->multiplicationTable[rhs].end());
+      for (size_t iter = 0; iter < this->elementNames.size(); ++iter) {
+        if (this->multiplicationTable(rhs, iter) == lhs) {
+          return true;
+        }
+      }
+      return false;
     }
   }
 
   bool Semigroup::l(size_t lhs, size_t rhs) const {
-    if (this->lOrder) {
-      return (*(this->lOrder))[lhs][rhs];
+    if (this->cache->lOrderReady) {
+      return this->cache->lOrder[lhs][rhs];
     }
     else {
       for (size_t iter = 0; iter < this->elementNames.size(); ++iter) {
-        if (this->multiplicationTable[iter][rhs] == lhs) {
+        if (this->multiplicationTable(iter, rhs) == lhs) {
           return true;
         }
       }
@@ -268,35 +281,174 @@ namespace omalg {
   }
 
   size_t Semigroup::jDepth(size_t index) const {
-    if (!this->jDepths) {
-      this->calculateJDepths();
-    }
-    return (*(this->jDepths))[index];
+    this->calculateJDepths();
+    return this->cache->jDepths[index];
+  }
+
+  void Semigroup::calculatePowerStructure() const {
+    std::call_once(this->cache->powerStructureFlag, [this]() {
+      size_t size = this->elementNames.size();
+      auto powerIndices = std::vector<size_t>(size, 0);
+      auto powerPeriods = std::vector<size_t>(size, 0);
+      auto idempotentPowers = std::vector<size_t>(size, 0);
+      //exponent[y] is k if y = x^k for the element x currently considered, which is recorded in owner[y].
+      auto exponent = std::vector<size_t>(size, 0);
+      auto owner = std::vector<size_t>(size, size);
+      auto powers = std::vector<size_t>();
+      for (size_t x = 0; x < size; ++x) {
+        powers.clear();
+        size_t current = x;
+        while (owner[current] != x) {
+          owner[current] = x;
+          powers.push_back(current);
+          exponent[current] = powers.size();
+          current = this->multiplicationTable(current, x);
+        }
+        //x^(k+1) = x^i for the index i and k = powers.size()
+        size_t i = exponent[current];
+        size_t p = powers.size() + 1 - i;
+        powerIndices[x] = i;
+        powerPeriods[x] = p;
+        //The idempotent power is x^m for the multiple m of p with i <= m < i + p.
+        size_t m = ((i + p - 1) / p) * p;
+        idempotentPowers[x] = powers[m - 1];
+      }
+      this->cache->powerIndices.swap(powerIndices);
+      this->cache->powerPeriods.swap(powerPeriods);
+      this->cache->idempotentPowers.swap(idempotentPowers);
+      this->cache->powerStructureReady = true;
+    });
+  }
+
+  size_t Semigroup::powerIndex(size_t index) const {
+    this->calculatePowerStructure();
+    return this->cache->powerIndices[index];
+  }
+
+  size_t Semigroup::powerPeriod(size_t index) const {
+    this->calculatePowerStructure();
+    return this->cache->powerPeriods[index];
   }
 
-  std::list<size_t> Semigroup::idempotents() const {
-    if (this->_idempotents.empty()) {
+  size_t Semigroup::idempotentPower(size_t index) const {
+    this->calculatePowerStructure();
+    return this->cache->idempotentPowers[index];
+  }
+
+  std::list<size_t> const& Semigroup::idempotents() const {
+    std::call_once(this->cache->idempotentsFlag, [this]() {
+      auto& idem = this->cache->idempotents;
       for (size_t e = 0; e < this->elementNames.size(); ++e) {
-        if (this->multiplicationTable[e][e] == e) {
-          this->_idempotents.insert(this->_idempotents.end(), e);
+        if (this->multiplicationTable(e, e) == e) {
+          idem.insert(idem.end(), e);
         }
       }
-    }
-    return this->_idempotents;
+      this->cache->idempotentsReady = true;
+    });
+    return this->cache->idempotents;
   }
 
-  std::list<std::pair<size_t, size_t> > Semigroup::linkedPairs() const {
-    if (this->_linkedPairs.empty()) {
-      auto idem = this->idempotents();
+  std::list<std::pair<size_t, size_t> > const& Semigroup::linkedPairs() const {
+    std::call_once(this->cache->linkedPairsFlag, [this]() {
+      auto const& idem = this->idempotents();
+      auto& pairs = this->cache->linkedPairs;
       for (size_t s = 0; s < this->elementNames.size(); ++s) {
         for (auto iter = idem.begin(); iter != idem.end(); ++iter) {
-          if (this->multiplicationTable[s][*iter] == s) {
-            this->_linkedPairs.insert(this->_linkedPairs.end(), std::make_pair(s, *iter));
+          if (this->multiplicationTable(s, *iter) == s) {
+            pairs.insert(pairs.end(), std::make_pair(s, *iter));
+          }
+        }
+      }
+      this->cache->linkedPairsReady = true;
+    });
+    return this->cache->linkedPairs;
+  }
+
+  std::vector<size_t> Semigroup::generatingSet(std::vector<size_t> const& elements) const {
+    size_t size = this->elementNames.size();
+    auto generators = std::vector<size_t>();
+    auto reached = std::vector<bool>(size, false);
+    //Reached elements in order of discovery.
+    auto closure = std::vector<size_t>();
+    auto Q = std::queue<size_t>();
+    //Adds a generator: the reached elements are multiplied with it, then the closure under all generators
+    //is continued from the new elements.
+    auto addGenerator = [&](size_t g) {
+      generators.push_back(g);
+      size_t known = closure.size();
+      if (!reached[g]) {
+        reached[g] = true;
+        closure.push_back(g);
+        Q.push(g);
+      }
+      for (size_t i = 0; i < known; ++i) {
+        size_t next = this->multiplicationTable(closure[i], g);
+        if (!reached[next]) {
+          reached[next] = true;
+          closure.push_back(next);
+          Q.push(next);
+        }
+      }
+      while (!Q.empty()) {
+        size_t cur = Q.front();
+        Q.pop();
+        for (auto iter = generators.begin(); iter != generators.end(); ++iter) {
+          size_t next = this->multiplicationTable(cur, *iter);
+          if (!reached[next]) {
+            reached[next] = true;
+            closure.push_back(next);
+            Q.push(next);
+          }
+        }
+      }
+    };
+    for (auto iter = elements.begin(); iter != elements.end(); ++iter) {
+      addGenerator(*iter);
+    }
+    //Add the least element not reached yet, one at a time, so elements generated by it are not added.
+    for (size_t s = 0; s < size; ++s) {
+      if (!reached[s]) {
+        addGenerator(s);
+      }
+    }
+    return generators;
+  }
+
+  bool Semigroup::isAssociative(std::vector<size_t> const& generators) const {
+    size_t size = this->elementNames.size();
+    for (auto iter = generators.begin(); iter != generators.end(); ++iter) {
+      for (size_t x = 0; x < size; ++x) {
+        size_t xg = this->multiplicationTable(x, *iter);
+        for (size_t y = 0; y < size; ++y) {
+          if (this->multiplicationTable(xg, y) != this->multiplicationTable(x, this->multiplicationTable(*iter, y))) {
+            return false;
           }
         }
       }
     }
-    return this->_linkedPairs;
+    return true;
+  }
+
+  bool Semigroup::isAperiodic(std::vector<size_t> const& generators) const {
+    size_t size = this->elementNames.size();
+    auto rightGraph = std::vector<std::vector<size_t> >(size, std::vector<size_t>(generators.size(), 0));
+    auto leftGraph = std::vector<std::vector<size_t> >(size, std::vector<size_t>(generators.size(), 0));
+    for (size_t s = 0; s < size; ++s) {
+      for (size_t g = 0; g < generators.size(); ++g) {
+        rightGraph[s][g] = this->multiplicationTable(s, generators[g]);
+        leftGraph[s][g] = this->multiplicationTable(generators[g], s);
+      }
+    }
+    auto rClasses = stronglyConnectedComponents(rightGraph);
+    auto lClasses = stronglyConnectedComponents(leftGraph);
+    //An H class is the intersection of an R class and an L class.
+    auto hClasses = std::unordered_set<size_t>();
+    for (size_t s = 0; s < size; ++s) {
+      if (!hClasses.insert(rClasses[s] * size + lClasses[s]).second) {
+        return false;
+      }
+    }
+    return true;
   }
 
   std::string Semigroup::description() const {
@@ -312,20 +464,18 @@ namespace omalg {
     
     //Multiplication table
     std::string table = "";
-    for(auto outerIter = this->multiplicationTable.begin();
-        outerIter != this->multiplicationTable.end();
-        ++outerIter) {
+    for (size_t row = 0; row < this->multiplicationTable.rowCount(); ++row) {
       //Add newline, but not at beginning
-      if (outerIter != this->multiplicationTable.begin()) {
+      if (row != 0) {
         table += "\n";
       }
       //Write table line
-      for(auto innerIter = outerIter->begin(); innerIter != outerIter->end(); ++innerIter) {
+      for (size_t column = 0; column < this->multiplicationTable.columnCount(); ++column) {
         //Add ',', but not at beginnning
-        if (!table.empty() && table.back() != '\n') {
+        if (column != 0) {
           table += ",";
         }
-        table += this->elementNames[*innerIter];
+        table += this->elementNames[this->multiplicationTable(row, column)];
       }
     }
     //Add final ';'
@@ -334,16 +484,5 @@ namespace omalg {
     return elementList + "\n" + table;
   }
 
-  Semigroup::~Semigroup() {
-    if (this->jOrder) {
-      delete jOrder;
-    }
-    if (this->lOrder) {
-      delete lOrder;
-    }
-    if (this->rOrder) {
-      delete rOrder;
-    }
-  }
+  Semigroup::~Semigroup() { }
 }
-
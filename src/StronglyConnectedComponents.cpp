@@ -0,0 +1,70 @@
+#include <limits>
+#include <stack>
+
+#include "StronglyConnectedComponents.h"
+
+namespace omalg {
+
+  std::vector<size_t> stronglyConnectedComponents(std::vector<std::vector<size_t> > const& graph) {
+    size_t const undefined = std::numeric_limits<size_t>::max();
+    size_t size = graph.size();
+    auto component = std::vector<size_t>(size, undefined);
+    auto index = std::vector<size_t>(size, undefined);
+    auto lowLink = std::vector<size_t>(size, 0);
+    auto onStack = std::vector<bool>(size, false);
+    auto sccStack = std::stack<size_t>();
+    //Call stack of the recursive formulation: node and next edge to consider.
+    auto callStack = std::stack<std::pair<size_t, size_t> >();
+    size_t nextIndex = 0;
+    size_t nextComponent = 0;
+
+    for (size_t root = 0; root < size; ++root) {
+      if (index[root] != undefined) {
+        continue;
+      }
+      callStack.push(std::make_pair(root, 0));
+      index[root] = lowLink[root] = nextIndex++;
+      sccStack.push(root);
+      onStack[root] = true;
+      while (!callStack.empty()) {
+        size_t cur = callStack.top().first;
+        size_t& edge = callStack.top().second;
+        if (edge < graph[cur].size()) {
+          size_t next = graph[cur][edge];
+          ++edge;
+          if (index[next] == undefined) {
+            index[next] = lowLink[next] = nextIndex++;
+            sccStack.push(next);
+            onStack[next] = true;
+            callStack.push(std::make_pair(next, 0));
+          }
+          else if (onStack[next] && index[next] < lowLink[cur]) {
+            lowLink[cur] = index[next];
+          }
+        }
+        else {
+          //All edges done: pop component if cur is its root, then return to the caller.
+          if (lowLink[cur] == index[cur]) {
+            size_t member;
+            do {
+              member = sccStack.top();
+              sccStack.pop();
+              onStack[member] = false;
+              component[member] = nextComponent;
+            } while (member != cur);
+            ++nextComponent;
+          }
+          callStack.pop();
+          if (!callStack.empty()) {
+            size_t caller = callStack.top().first;
+            if (lowLink[cur] < lowLink[caller]) {
+              lowLink[caller] = lowLink[cur];
+            }
+          }
+        }
+      }
+    }
+    return component;
+  }
+
+}
@@ -0,0 +1,276 @@
+#include <iostream>
+#include <sstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "OmegaSemigroup.h"
+#include "OmegaAutomaton.h"
+#include "DeterministicBuechiAutomaton.h"
+#include "DeterministicCoBuechiAutomaton.h"
+#include "DeterministicMullerAutomaton.h"
+#include "DeterministicParityAutomaton.h"
+#include "NondeterministicBuechiAutomaton.h"
+#include "NondeterministicCoBuechiAutomaton.h"
+#include "NondeterministicMullerAutomaton.h"
+#include "NondeterministicParityAutomaton.h"
+#include "AutomatonSink.h"
+#include "GeneralException.h"
+#include "IOHandler.h"
+#include "IOHandlerExceptions.h"
+
+namespace {
+
+  typedef std::vector<size_t> Word;
+
+  /**
+   * An ultimately periodic word u v^w over the letter indices of the input automaton.
+   */
+  struct Lasso {
+    Word prefix;
+    Word period;
+  };
+
+  /**
+   * Enumerates all lassos u v^w with |u| <= maxPrefix and 1 <= |v| <= maxPeriod.
+   */
+  std::vector<Lasso> lassos(size_t alphabetSize, size_t maxPrefix, size_t maxPeriod) {
+    //All words up to the larger length, by increasing length
+    auto words = std::vector<Word>(1, Word());
+    for (size_t begin = 0, length = 0; length < std::max(maxPrefix, maxPeriod); ++length) {
+      size_t end = words.size();
+      for (size_t i = begin; i < end; ++i) {
+        for (size_t letter = 0; letter < alphabetSize; ++letter) {
+          Word word = words[i];
+          word.push_back(letter);
+          words.push_back(word);
+        }
+      }
+      begin = end;
+    }
+    auto result = std::vector<Lasso>();
+    for (auto const& prefix : words) {
+      for (auto const& period : words) {
+        if (prefix.size() <= maxPrefix && !period.empty() && period.size() <= maxPeriod) {
+          result.push_back(Lasso{prefix, period});
+        }
+      }
+    }
+    return result;
+  }
+
+  /**
+   * Decides acceptance of a lasso with the transition profiles of the automaton: u v^w is accepted iff
+   * the omega profile of u * v^w holds at the initial state.
+   * @param letters Letter of the automaton for each letter of the input alphabet.
+   */
+  template<class T>
+  bool accepts(T const& A, std::vector<size_t> const& letters, Lasso const& lasso) {
+    auto period = A.getTransitionProfileForLetter(letters[lasso.period[0]]);
+    for (size_t i = 1; i < lasso.period.size(); ++i) {
+      period = period.concat(A.getTransitionProfileForLetter(letters[lasso.period[i]]));
+    }
+    //The omega iteration is taken of an idempotent power, as in the construction of the omega semigroup.
+    auto power = period;
+    while (!(power.concat(power) == power)) {
+      power = power.concat(period);
+    }
+    auto prefix = A.getEpsilonProfile();
+    for (size_t i = 0; i < lasso.prefix.size(); ++i) {
+      prefix = prefix.concat(A.getTransitionProfileForLetter(letters[lasso.prefix[i]]));
+    }
+    return prefix.mixedProduct(power.omegaIteration())[A.getInitialState()];
+  }
+
+  /**
+   * Maps the letters of the input alphabet to the letters of an automaton, by name.
+   */
+  std::vector<size_t> letterMap(std::vector<std::string> const& inputAlphabet, omalg::OmegaAutomaton const& A) {
+    auto alphabet = A.getAlphabet();
+    auto result = std::vector<size_t>(inputAlphabet.size(), 0);
+    for (size_t letter = 0; letter < inputAlphabet.size(); ++letter) {
+      result[letter] = std::find(alphabet.begin(), alphabet.end(), inputAlphabet[letter]) - alphabet.begin();
+    }
+    return result;
+  }
+
+  /**
+   * The language of an automaton of any concrete type on the given lassos, as bit vector.
+   */
+  std::vector<bool> language(omalg::OmegaAutomaton const& A, std::vector<std::string> const& inputAlphabet,
+                             std::vector<Lasso> const& lassos) {
+    auto letters = letterMap(inputAlphabet, A);
+    auto result = std::vector<bool>(lassos.size(), false);
+    for (size_t i = 0; i < lassos.size(); ++i) {
+      if (auto B = dynamic_cast<omalg::DeterministicBuechiAutomaton const*>(&A)) {
+        result[i] = accepts(*B, letters, lassos[i]);
+      }
+      else if (auto B = dynamic_cast<omalg::DeterministicCoBuechiAutomaton const*>(&A)) {
+        result[i] = accepts(*B, letters, lassos[i]);
+      }
+      else if (auto B = dynamic_cast<omalg::DeterministicMullerAutomaton const*>(&A)) {
+        result[i] = accepts(*B, letters, lassos[i]);
+      }
+      else if (auto B = dynamic_cast<omalg::DeterministicParityAutomaton const*>(&A)) {
+        result[i] = accepts(*B, letters, lassos[i]);
+      }
+      else if (auto B = dynamic_cast<omalg::NondeterministicBuechiAutomaton const*>(&A)) {
+        result[i] = accepts(*B, letters, lassos[i]);
+      }
+      else if (auto B = dynamic_cast<omalg::NondeterministicCoBuechiAutomaton const*>(&A)) {
+        result[i] = accepts(*B, letters, lassos[i]);
+      }
+      else if (auto B = dynamic_cast<omalg::NondeterministicMullerAutomaton const*>(&A)) {
+        result[i] = accepts(*B, letters, lassos[i]);
+      }
+      else if (auto B = dynamic_cast<omalg::NondeterministicParityAutomaton const*>(&A)) {
+        result[i] = accepts(*B, letters, lassos[i]);
+      }
+    }
+    return result;
+  }
+
+  /**
+   * Compares and reports the languages of a constructed automaton and of the input automaton.
+   */
+  class Checker {
+  private:
+    std::string name;
+    std::vector<std::string> inputAlphabet;
+    std::vector<Lasso> words;
+    std::vector<bool> expected;
+    bool passed;
+
+  public:
+    Checker(std::string const& theName, omalg::OmegaAutomaton const& input)
+      : name(theName), inputAlphabet(input.getAlphabet()), passed(true) {
+      bool large = this->inputAlphabet.size() > 2;
+      this->words = lassos(this->inputAlphabet.size(), large ? 2 : 3, large ? 3 : 4);
+      this->expected = language(input, this->inputAlphabet, this->words);
+    }
+
+    bool ok() const {
+      return this->passed;
+    }
+
+    void fail(std::string const& message) {
+      std::cerr << this->name << ": " << message << std::endl;
+      this->passed = false;
+    }
+
+    void sameLanguage(omalg::OmegaAutomaton const& A, std::string const& kind) {
+      auto actual = language(A, this->inputAlphabet, this->words);
+      for (size_t i = 0; i < this->words.size(); ++i) {
+        if (actual[i] != this->expected[i]) {
+          this->fail(kind + " automaton differs from the input on a lasso with prefix length "
+                     + std::to_string(this->words[i].prefix.size()) + " and period length "
+                     + std::to_string(this->words[i].period.size()));
+          return;
+        }
+      }
+    }
+
+    void sameDescription(std::string const& lhs, std::string const& rhs, std::string const& what) {
+      if (lhs != rhs) {
+        this->fail(what + " differ");
+      }
+    }
+  };
+
+  /**
+   * Runs a deterministic conversion which is only applicable for some languages. With one and two threads
+   * the results must agree, and the streamed output must match the description.
+   * @param applicable Whether the language belongs to the class of the conversion.
+   */
+  template<class Build, class Stream>
+  void checkConversion(Checker& checker, std::string const& kind, bool applicable, Build build, Stream stream) {
+    try {
+      auto A = build(1);
+      if (!applicable) {
+        checker.fail(kind + " conversion succeeded outside of its class");
+        return;
+      }
+      checker.sameLanguage(A, kind);
+      checker.sameDescription(A.description(), build(2).description(), kind + " automata with one and two threads");
+      std::ostringstream out;
+      omalg::StreamAutomatonSink sink(out);
+      stream(sink);
+      checker.sameDescription(A.description(), out.str(), kind + " description and streamed output");
+    }
+    catch (omalg::OperationNotApplicableException const&) {
+      if (applicable) {
+        checker.fail(kind + " conversion rejected a language of its class");
+      }
+    }
+  }
+
+  /**
+   * Checks all conversions of an omega semigroup for the language of the input automaton, with and without
+   * reduction of the nondet. Buechi automaton, and that the combined conversion streams the same automata.
+   */
+  void checkConversions(Checker& checker, omalg::OmegaSemigroup const& S) {
+    checkConversion(checker, "parity", true,
+                    [&](unsigned threads) { return S.toParity(threads); },
+                    [&](omalg::AutomatonSink& sink) { S.toParity(sink); });
+    checkConversion(checker, "coBuechi", S.isDCRecognizable(),
+                    [&](unsigned threads) { return S.toCoBuechi(threads); },
+                    [&](omalg::AutomatonSink& sink) { S.toCoBuechi(sink); });
+    checkConversion(checker, "det. Buechi", S.isDBRecognizable(),
+                    [&](unsigned threads) { return S.toDetBuechi(threads); },
+                    [&](omalg::AutomatonSink& sink) { S.toDetBuechi(sink); });
+    checkConversion(checker, "weak Buechi", S.isWBRecognizable(),
+                    [&](unsigned) { return S.toWeakBuechi(); },
+                    [&](omalg::AutomatonSink& sink) { S.toWeakBuechi(sink); });
+    checker.sameLanguage(S.toNondeterministicBuechi(false), "nondet. Buechi");
+    checker.sameLanguage(S.toNondeterministicBuechi(true), "reduced nondet. Buechi");
+
+    std::ostringstream weakBuechi, coBuechi, detBuechi, parity;
+    omalg::StreamAutomatonSink weakBuechiSink(weakBuechi), coBuechiSink(coBuechi), detBuechiSink(detBuechi), paritySink(parity);
+    unsigned classes = S.toAutomata(&weakBuechiSink, &coBuechiSink, &detBuechiSink, &paritySink, 2);
+    checker.sameDescription(parity.str(), S.toParity().description(), "combined and single parity conversion");
+    if (classes & omalg::OmegaSemigroup::DC) {
+      checker.sameDescription(coBuechi.str(), S.toCoBuechi().description(), "combined and single coBuechi conversion");
+    }
+    if (classes & omalg::OmegaSemigroup::DB) {
+      checker.sameDescription(detBuechi.str(), S.toDetBuechi().description(), "combined and single det. Buechi conversion");
+    }
+    if (classes & omalg::OmegaSemigroup::WB) {
+      checker.sameDescription(weakBuechi.str(), S.toWeakBuechi().description(), "combined and single weak Buechi conversion");
+    }
+  }
+}
+
+/**
+ * Converts the omega semigroup of each given automaton into automata of the supported kinds, and compares
+ * their languages with the input automaton on all short lassos. This is done for the omega semigroup of
+ * the automaton and for its syntactic omega semigroup.
+ * @param argc The number of command line arguments.
+ * @param argv The input automata.
+ * @return 0 if and only if all checks pass.
+ */
+int main(int argc, char const* argv[]) {
+  int result = EXIT_SUCCESS;
+  for (int arg = 1; arg < argc; ++arg) {
+    std::string fileName = argv[arg];
+    try {
+      std::unique_ptr<omalg::OmegaAutomaton> A(omalg::IOHandler::getInstance().readAutomatonFromFile(fileName));
+      std::unique_ptr<omalg::OmegaSemigroup> S(A->toOmegaSemigroup());
+      S->reduceToGenerated();
+      auto syntactic = *S;
+      syntactic.reduceToSyntactic();
+
+      Checker checker(fileName, *A);
+      checkConversions(checker, *S);
+      checkConversions(checker, syntactic);
+      if (!checker.ok()) {
+        result = EXIT_FAILURE;
+      }
+    }
+    catch (omalg::IOException const& e) {
+      std::cerr << fileName << ": " << e.what() << std::endl;
+      result = EXIT_FAILURE;
+    }
+  }
+  return result;
+}
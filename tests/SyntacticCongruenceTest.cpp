@@ -0,0 +1,116 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "OmegaSemigroup.h"
+#include "OmegaAutomaton.h"
+#include "IOHandler.h"
+#include "IOHandlerExceptions.h"
+
+namespace {
+
+  /**
+   * Splits a description in the omalg format into its sections, without the terminating ';'.
+   */
+  std::vector<std::string> sections(std::string const& description) {
+    auto result = std::vector<std::string>();
+    std::istringstream in(description);
+    std::string section;
+    while (std::getline(in, section, ';')) {
+      result.push_back(section);
+    }
+    return result;
+  }
+
+  /**
+   * Reads back an omega semigroup with the images of all letters replaced, such that the images in general
+   * do not generate the whole semigroup.
+   * @param S The original omega semigroup.
+   * @param shift Letter i is mapped to element (i + shift) mod n, for n elements. For shift = 0 instead
+   *              every letter is mapped to the first element.
+   * @param fileName Name of the temporary file to use.
+   */
+  std::unique_ptr<omalg::OmegaSemigroup> withImages(omalg::OmegaSemigroup const& S, size_t shift, std::string const& fileName) {
+    auto parts = sections(S.description());
+    std::vector<std::string> elements;
+    std::istringstream in(parts[0]);
+    std::string element;
+    while (std::getline(in, element, ',')) {
+      elements.push_back(element.substr(element.find_first_not_of("\n")));
+    }
+    size_t letters = 1 + std::count(parts[5].begin(), parts[5].end(), ',');
+    std::string images = "\n";
+    for (size_t i = 0; i < letters; ++i) {
+      images += (i == 0 ? "" : ",") + elements[shift == 0 ? 0 : (i + shift) % elements.size()];
+    }
+    parts[6] = images;
+    std::ofstream out(fileName);
+    for (auto const& part : parts) {
+      out << part << ";";
+    }
+    out.close();
+    return std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromFile(fileName, true));
+  }
+
+  /**
+   * Checks that both syntactic congruence engines yield the same reduced omega semigroup.
+   * @return true iff the results agree.
+   */
+  bool enginesAgree(omalg::OmegaSemigroup const& S, std::string const& name) {
+    auto refined = S;
+    refined.reduceToSyntactic(false);
+    bool agree = true;
+    for (unsigned threads = 1; threads <= 2; ++threads) {
+      auto bySignatures = S;
+      bySignatures.reduceToSyntactic(true, threads);
+      if (bySignatures.description() != refined.description()) {
+        std::cerr << name << ": signatures with " << threads << " thread(s) disagree with partition refinement" << std::endl;
+        agree = false;
+      }
+    }
+    return agree;
+  }
+}
+
+/**
+ * Compares the partition refinement and the signature engine for the syntactic congruence. The arguments
+ * are automata, or omega semigroups if the file name ends in .os. Each input is checked as given and with
+ * its letters mapped to other elements, so that the images need not generate the semigroup.
+ * @param argc The number of command line arguments.
+ * @param argv The input files.
+ * @return 0 if and only if all checks pass.
+ */
+int main(int argc, char const* argv[]) {
+  int result = EXIT_SUCCESS;
+  for (int arg = 1; arg < argc; ++arg) {
+    std::string fileName = argv[arg];
+    std::unique_ptr<omalg::OmegaSemigroup> S;
+    try {
+      if (fileName.size() > 3 && fileName.substr(fileName.size() - 3) == ".os") {
+        S = std::unique_ptr<omalg::OmegaSemigroup>(omalg::IOHandler::getInstance().readOmegaSemigroupFromFile(fileName, true));
+      }
+      else {
+        std::unique_ptr<omalg::OmegaAutomaton> A(omalg::IOHandler::getInstance().readAutomatonFromFile(fileName));
+        S = std::unique_ptr<omalg::OmegaSemigroup>(A->toOmegaSemigroup());
+      }
+      if (!enginesAgree(*S, fileName)) {
+        result = EXIT_FAILURE;
+      }
+      for (size_t shift = 0; shift < 3; ++shift) {
+        auto T = withImages(*S, shift, "SyntacticCongruenceTest.os");
+        if (!enginesAgree(*T, fileName + " (images shifted by " + std::to_string(shift) + ")")) {
+          result = EXIT_FAILURE;
+        }
+      }
+    }
+    catch (omalg::IOException const& e) {
+      std::cerr << fileName << ": " << e.what() << std::endl;
+      result = EXIT_FAILURE;
+    }
+  }
+  return result;
+}
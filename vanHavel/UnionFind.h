@@ -2,6 +2,7 @@
 #define	VANHAVEL_UNION_FIND
 
 #include <vector>
+#include <cstddef>
 
 namespace vanHavel {
   